@@ -0,0 +1,205 @@
+//----------------------------------------------------------------------
+// FILE: adaptive_collection
+// NAME: Scott Tornquist
+// DATE: 10/19/2026
+// DESC: Implements a collection that changes representation with its
+//       size. Up to PROMOTE_SIZE pairs are kept in two small arrays
+//       stored inside the object and searched linearly, so small maps
+//       allocate nothing and never chase pointers. The next add moves
+//       every pair into a red-black tree, and removes that leave the
+//       tree with fewer than DEMOTE_SIZE pairs move them back. The gap
+//       between the two sizes keeps a collection hovering around one
+//       of them from switching back and forth.
+//----------------------------------------------------------------------
+
+
+#ifndef ADAPTIVE_COLLECTION_H
+#define ADAPTIVE_COLLECTION_H
+
+#include "array_list.h"
+#include "small_array_list.h"
+#include "collection.h"
+#include "rbt_collection.h"
+
+template<typename K, typename V>
+class AdaptiveCollection : public Collection<K,V>
+{
+public:
+  // add a new key-value pair into the collection
+    void add(const K& a_key, const V& a_val);
+
+  // remove a key-value pair from the collection
+    void remove(const K& a_key);
+
+  // find and return the value associated with the key
+  // if key isn't found, returns false, otherwise true
+    bool find(const K& search_key, V& the_val) const;
+
+  // find and return each key >= k1 and <= k2
+    void find(const K& k1, const K& k2, ArrayList<K>& keys) const;
+
+  // return all of the keys in the collection
+    void keys(ArrayList<K>& all_keys) const;
+
+  // return all of the keys in ascending (sorted) order
+    void sort(ArrayList<K>& all_keys_sorted) const;
+
+  // return the number of key-value pairs in the collection
+    size_t size() const;
+
+  // true while the pairs are kept in the tree
+    bool is_promoted() const;
+
+    // most pairs kept in the inline arrays
+    static const size_t PROMOTE_SIZE = 32;
+
+    // a tree with fewer pairs than this moves back to the arrays
+    static const size_t DEMOTE_SIZE = 8;
+
+private:
+  // the i-th key goes with the i-th value (while not promoted)
+  SmallArrayList<K,PROMOTE_SIZE> key_list;
+  SmallArrayList<V,PROMOTE_SIZE> val_list;
+
+  // every pair once promoted (empty, and allocation free, before)
+  RBTCollection<K,V> tree;
+  bool promoted = false;
+
+    // index of key in key_list, or key_list.size() if it is not there
+    size_t index_of(const K& key) const;
+
+    // move every pair from the arrays into the tree
+    void promote();
+
+    // move every pair from the tree back into the arrays
+    void demote();
+};
+
+template<typename K, typename V>
+ size_t AdaptiveCollection<K,V>:: index_of(const K& key) const{
+   const K* keys = key_list.data();
+   size_t n = key_list.size();
+   for(size_t i = 0; i<n; i++){
+     if(keys[i] == key){
+       return i;
+     }
+   }
+   return n;
+ };
+
+template<typename K, typename V>
+ void AdaptiveCollection<K,V>:: promote(){
+   const K* keys = key_list.data();
+   const V* vals = val_list.data();
+   for(size_t i = 0; i<key_list.size(); i++){
+     tree.add(keys[i], vals[i]);
+   }
+   key_list.clear();
+   val_list.clear();
+   promoted = true;
+ };
+
+template<typename K, typename V>
+ void AdaptiveCollection<K,V>:: demote(){
+   tree.keys(key_list); // fits inline, so this allocates nothing
+   for(size_t i = 0; i<key_list.size(); i++){
+     V val;
+     tree.find(key_list.data()[i], val);
+     val_list.add(val);
+   }
+   tree = RBTCollection<K,V>();
+   promoted = false;
+ };
+
+template<typename K, typename V>
+ void AdaptiveCollection<K,V>:: add(const K& a_key, const V& a_val){
+   if(!promoted && key_list.size() == PROMOTE_SIZE){ // outgrew the arrays
+     promote();
+   }
+   if(promoted){
+     tree.add(a_key, a_val);
+     return;
+   }
+   key_list.add(a_key);
+   val_list.add(a_val);
+ };
+
+template<typename K, typename V>
+ void AdaptiveCollection<K,V>:: remove(const K& a_key){
+   if(promoted){
+     tree.remove(a_key);
+     if(tree.size() < DEMOTE_SIZE){
+       demote();
+     }
+     return;
+   }
+   size_t i = index_of(a_key);
+   size_t last = key_list.size() - 1;
+   if(i < key_list.size()){ // order doesn't matter, so fill the hole with the last pair
+     if(i != last){
+       key_list.data()[i] = std::move(key_list.data()[last]);
+       val_list.data()[i] = std::move(val_list.data()[last]);
+     }
+     key_list.erase(last, last + 1);
+     val_list.erase(last, last + 1);
+   }
+ };
+
+template<typename K, typename V>
+ bool AdaptiveCollection<K,V>:: find(const K& search_key, V& the_val) const{
+   if(promoted){
+     return tree.find(search_key, the_val);
+   }
+   size_t i = index_of(search_key);
+   if(i < key_list.size()){
+     the_val = val_list.data()[i];
+     return true;
+   }
+   return false; // if not found return false
+ };
+
+template<typename K, typename V>
+ void AdaptiveCollection<K,V>:: find(const K& k1, const K& k2, ArrayList<K>& keys) const{
+   if(promoted){
+     tree.find(k1, k2, keys);
+     return;
+   }
+   keys.clear();
+   const K* all = key_list.data();
+   for(size_t i = 0; i<key_list.size(); i++){
+     if(all[i] >= k1 && all[i] <= k2){
+       keys.add(all[i]);
+     }
+   }
+ };
+
+template<typename K, typename V>
+ void AdaptiveCollection<K,V>:: keys(ArrayList<K>& all_keys) const{
+   if(promoted){
+     tree.keys(all_keys);
+     return;
+   }
+   all_keys.clear();
+   all_keys.append(key_list.data(), key_list.size());
+ };
+
+template<typename K, typename V>
+ void AdaptiveCollection<K,V>:: sort(ArrayList<K>& all_keys_sorted) const{
+   keys(all_keys_sorted); // the tree already hands them back in order
+   if(!promoted){
+     all_keys_sorted.sort();
+   }
+ };
+
+template<typename K, typename V>
+ size_t AdaptiveCollection<K,V>:: size() const{
+   return promoted ? tree.size() : key_list.size();
+ };
+
+template<typename K, typename V>
+ bool AdaptiveCollection<K,V>:: is_promoted() const{
+   return promoted;
+ };
+
+
+#endif
@@ -11,6 +11,27 @@
 #define ARRAY_LIST_H
 
 #include "list.h"
+#include <utility>
+#include <thread>
+#include <string>
+#include <type_traits>
+#include <functional>
+#include <cstring>
+#include <new>
+
+// radix_sort() picks its algorithm at compile time from these tags
+struct comparison_sort_tag {};
+struct integer_radix_sort_tag {};
+struct string_radix_sort_tag {};
+
+template<typename T, bool = std::is_integral<T>::value && !std::is_same<T,bool>::value>
+struct radix_sort_category { typedef comparison_sort_tag type; };
+
+template<typename T>
+struct radix_sort_category<T,true> { typedef integer_radix_sort_tag type; };
+
+template<>
+struct radix_sort_category<std::string,false> { typedef string_radix_sort_tag type; };
 
 template<typename T>
 class ArrayList : public List<T>
@@ -18,8 +39,10 @@ class ArrayList : public List<T>
 public:
   ArrayList();
   ArrayList(const ArrayList<T>& rhs);
+  ArrayList(ArrayList<T>&& rhs);
   ~ArrayList();
   ArrayList& operator=(const ArrayList<T>& rhs);
+  ArrayList& operator=(ArrayList<T>&& rhs);
   //hw1
   void add(const T& item);
   bool add(size_t index, const T& item);
@@ -32,72 +55,576 @@ public:
   void insertion_sort();
   void swap(size_t x, size_t y);
   //hw3
+  // stable bottom-up merge sort, galloping through ordered stretches
   void merge_sort();
   void quick_sort();
   //hw4
+  // introsort: ninther pivots, insertion sort for short ranges and a
+  // heapsort fallback, with sorted and reversed input found in O(n);
+  // lists of PARALLEL_SORT_THRESHOLD or more items use parallel_sort
   void sort();
+  // sorts chunks on up to threads workers (0 = one per core) and then
+  // merges them pairwise in parallel through one scratch array
+  void parallel_sort(size_t threads = 0);
+  // LSD radix sort for integral items, multikey quicksort for strings
+  // and sort() for anything else
+  void radix_sort();
+  // removes every item (in O(1) for trivially destructible items),
+  // keeping the capacity for reuse
+  void clear();
+  // grows the capacity to at least n items
+  void reserve(size_t n);
+  // releases any capacity beyond the current size
+  void shrink_to_fit();
+  // adds n items to the end, growing at most once
+  void append(const T* first, size_t n);
+  // inserts n items before index (index == size() appends), moving the
+  // tail once; returns false if index is out of range
+  bool insert(size_t index, const T* first, size_t n);
+  // removes the items in [first, last), moving the tail once; returns
+  // false if the range is out of bounds
+  bool erase(size_t first, size_t last);
+  // the underlying array of size() items (nullptr if there are none)
+  T* data();
+  const T* data() const;
+
+protected:
+  // for SmallArrayList: starts out using the caller's buffer of n raw
+  // slots, which is never freed and is reused whenever items fit
+  ArrayList(T* buffer, size_t n);
+  // true while the items live in the inline buffer
+  bool using_inline() const;
+  // takes rhs's items (stealing its heap array when it has one) into
+  // this empty list, leaving rhs empty
+  void take(ArrayList<T>& rhs);
 
 private:
 // i needed this public so i could test items to make sure they are bieng updated and tracked correctly
-  T* items; //pointer to an array
+  T* items; //pointer to raw storage, only [0, length) is constructed
   size_t capacity;
   size_t length;
+  // inline storage of a SmallArrayList (nullptr for a plain ArrayList)
+  T* inline_buffer;
+  size_t inline_capacity;
+  // frees ptr unless it is the inline buffer
+  void release(T* ptr);
   // helper to resize items array
   void resize();
+  // makes room for at least n items, doubling if that is larger
+  void grow_to(size_t n);
+  // moves the items into new storage of n slots (n >= length)
+  void reallocate(size_t n);
+  // true if item lives inside this list's storage
+  bool owns(const T& item) const;
+  // raw storage helpers; trivially copyable items are moved with
+  // memcpy/memmove, everything else is moved (or copied) one by one
+  typedef typename std::is_trivially_copyable<T>::type trivial_tag;
+  static T* allocate(size_t n);
+  static void deallocate(T* ptr);
+  static void destroy(T* first, size_t n);
+  static void relocate(T* dst, T* src, size_t n);
+  static void relocate(T* dst, T* src, size_t n, std::true_type);
+  static void relocate(T* dst, T* src, size_t n, std::false_type);
+  static void copy_construct(T* dst, const T* src, size_t n);
+  static void copy_construct(T* dst, const T* src, size_t n, std::true_type);
+  static void copy_construct(T* dst, const T* src, size_t n, std::false_type);
+  // open (or close) a one item gap at index by shifting the tail
+  void open_gap(size_t index, std::true_type);
+  void open_gap(size_t index, std::false_type);
+  void close_gap(size_t index, std::true_type);
+  void close_gap(size_t index, std::false_type);
   //hw3 helper functions
-  void merge_sort(size_t start, size_t end);
+  static const size_t MIN_GALLOP = 7;
+  void merge_lo(size_t lo, size_t mid, size_t hi, T* scratch);
+  static size_t gallop_upper(const T& key, const T* run, size_t n);
+  static size_t gallop_lower(const T& key, const T* run, size_t n);
   void quick_sort(size_t start, size_t end);
+  // sort() helpers, all over the half-open range [first, last)
+  static const size_t INSERTION_SORT_CUTOFF = 16;
+  static const size_t PARALLEL_SORT_THRESHOLD = 1 << 17;
+  static const size_t MAX_SORT_THREADS = 64;
+  static size_t sort_depth_limit(size_t n);
+  void sort_range(size_t first, size_t last);
+  static void merge_runs(T* src, T* dst, size_t lo, size_t mid, size_t hi);
+  void intro_sort(size_t first, size_t last, size_t depth_limit);
+  void insertion_sort(size_t first, size_t last);
+  bool partial_insertion_sort(size_t first, size_t last);
+  void heap_sort(size_t first, size_t last);
+  void sift_down(size_t first, size_t root, size_t n);
+  void sort3(size_t a, size_t b, size_t c);
+  // radix_sort() helpers
+  static const size_t RADIX_SORT_CUTOFF = 64;
+  void radix_sort(comparison_sort_tag);
+  void radix_sort(integer_radix_sort_tag);
+  void radix_sort(string_radix_sort_tag);
+  void multikey_quick_sort(size_t first, size_t last, size_t depth);
 };
 
 template <typename T>
 void ArrayList<T>:: sort() {
-  quick_sort();
+  if(length < 2){
+    return;
+  }
+  // already sorted or reverse sorted input (e.g. keys fed back in
+  // after a rehash) is detected up front in one pass
+  size_t run = 1;
+  while(run < length && !(items[run] < items[run-1])){
+    run++;
+  }
+  if(run == length){
+    return;
+  }
+  if(run == 1){
+    while(run < length && items[run] < items[run-1]){
+      run++;
+    }
+    if(run == length){ // strictly descending, so reversing sorts it
+      for(size_t i = 0, j = length-1; i < j; i++, j--){
+        swap(i, j);
+      }
+      return;
+    }
+  }
+  if(length >= PARALLEL_SORT_THRESHOLD){
+    parallel_sort();
+  }
+  else{
+    sort_range(0, length);
+  }
 }
 
 template <typename T>
-void ArrayList<T>:: merge_sort(){
-  if(size()>1){
-  size_t start = 0;
-  size_t end = size()-1;
-  size_t mid = (start + end)/2;
-  merge_sort(0, end);
-  //merge_sort(mid+1, end);
+void ArrayList<T>:: parallel_sort(size_t threads){
+  if(threads == 0){
+    threads = std::thread::hardware_concurrency();
   }
-};
+  if(threads > MAX_SORT_THREADS){
+    threads = MAX_SORT_THREADS;
+  }
+  size_t chunks = 1; // a power of two so the merge rounds pair up evenly
+  while(chunks*2 <= threads && chunks*2*INSERTION_SORT_CUTOFF <= length){
+    chunks *= 2;
+  }
+  if(chunks < 2){
+    sort_range(0, length);
+    return;
+  }
+  size_t* bounds = new size_t[chunks+1];
+  for(size_t c=0; c<=chunks; c++){
+    bounds[c] = length/chunks*c + (length%chunks)*c/chunks;
+  }
+  std::thread* workers = new std::thread[chunks];
+  for(size_t c=0; c<chunks; c++){ // every chunk sorted on its own thread
+    workers[c] = std::thread(&ArrayList<T>::sort_range, this, bounds[c], bounds[c+1]);
+  }
+  for(size_t c=0; c<chunks; c++){
+    workers[c].join();
+  }
+  // merge rounds ping-pong between items and one raw scratch array
+  T* scratch = allocate(capacity);
+  T* src = items;
+  T* dst = scratch;
+  for(size_t width=1; width<chunks; width*=2){
+    size_t pairs = chunks/(2*width);
+    for(size_t p=0; p<pairs; p++){
+      size_t c = 2*width*p;
+      workers[p] = std::thread(&ArrayList<T>::merge_runs, src, dst,
+                               bounds[c], bounds[c+width], bounds[c+2*width]);
+    }
+    for(size_t p=0; p<pairs; p++){
+      workers[p].join();
+    }
+    std::swap(src, dst);
+  }
+  if(src != items){ // the result ended up in the scratch array
+    release(items);
+    items = src;
+  }
+  else{
+    deallocate(scratch);
+  }
+  delete [] workers;
+  delete [] bounds;
+}
 
 template <typename T>
-void ArrayList<T>:: merge_sort(size_t start, size_t end){
-  if(start < end){
-    size_t mid = (start + end)/2;
-    merge_sort(start, mid);
-    merge_sort(mid+1, end);
-    T*tmp = new T[(end-start)+1];
-    int first1 = start;
-    int first2 = mid+1;
-    int i = 0;
-    while((first1 <= mid) && (first2 <= end)){
-      if(items[first1+1] < items[first2]){
-       tmp[i] = items[first1];
-       first1++;
-       i++;
+size_t ArrayList<T>:: sort_depth_limit(size_t n){
+  size_t limit = 0; // 2*log2(n) levels before giving up on quicksort
+  for(; n > 1; n >>= 1){
+    limit += 2;
+  }
+  return limit;
+}
+
+template <typename T>
+void ArrayList<T>:: sort_range(size_t first, size_t last){
+  if(last - first > 1){
+    intro_sort(first, last, sort_depth_limit(last - first));
+  }
+}
+
+template <typename T>
+void ArrayList<T>:: merge_runs(T* src, T* dst, size_t lo, size_t mid, size_t hi){
+  // stable merge of src[lo,mid) and src[mid,hi) into raw dst[lo,hi),
+  // leaving src[lo,hi) raw
+  size_t i = lo;
+  size_t j = mid;
+  size_t k = lo;
+  if(lo < mid && mid < hi && src[mid] < src[mid-1]){
+    while(i < mid && j < hi){
+      if(src[j] < src[i]){
+        relocate(dst + k++, src + j++, 1);
+      }
+      else{
+        relocate(dst + k++, src + i++, 1);
+      }
+    }
+  }
+  // already in order runs are just moved across
+  relocate(dst + k, src + i, mid - i);
+  k += mid - i;
+  relocate(dst + k, src + j, hi - j);
+}
+
+template <typename T>
+void ArrayList<T>:: intro_sort(size_t first, size_t last, size_t depth_limit){
+  while(last - first > INSERTION_SORT_CUTOFF){
+    if(depth_limit == 0){ // too many bad pivots, heapsort bounds the rest
+      heap_sort(first, last);
+      return;
+    }
+    depth_limit--;
+    // median of three (ninther for big ranges) moved to the front
+    size_t n = last - first;
+    size_t mid = first + n/2;
+    if(n > 128){
+      size_t step = n/8;
+      sort3(first, first+step, first+2*step);
+      sort3(mid-step, mid, mid+step);
+      sort3(last-1-2*step, last-1-step, last-1);
+      sort3(first+step, mid, last-1-step);
+    }
+    else{
+      sort3(first, mid, last-1);
+    }
+    swap(first, mid);
+    // Hoare partition, both scans stop on equal keys so runs of
+    // duplicates split evenly instead of going quadratic
+    size_t i = first;
+    size_t j = last;
+    bool swapped = false;
+    for(;;){
+      do{ i++; } while(i < last && items[i] < items[first]);
+      do{ j--; } while(items[first] < items[j]);
+      if(i >= j){
+        break;
+      }
+      swap(i, j);
+      swapped = true;
+    }
+    swap(first, j);
+    // a partition with no swaps hints the range was nearly sorted
+    if(!swapped && partial_insertion_sort(first, j) && partial_insertion_sort(j+1, last)){
+      return;
+    }
+    if(j - first < last - (j+1)){ // recurse on the smaller side
+      intro_sort(first, j, depth_limit);
+      first = j+1;
+    }
+    else{
+      intro_sort(j+1, last, depth_limit);
+      last = j;
+    }
+  }
+  insertion_sort(first, last);
+}
+
+template <typename T>
+void ArrayList<T>:: insertion_sort(size_t first, size_t last){
+  for(size_t i = first+1; i < last; i++){
+    if(items[i] < items[i-1]){
+      T saver = std::move(items[i]);
+      size_t k = i;
+      do{
+        items[k] = std::move(items[k-1]);
+        k--;
+      } while(k > first && saver < items[k-1]);
+      items[k] = std::move(saver);
+    }
+  }
+}
+
+template <typename T>
+bool ArrayList<T>:: partial_insertion_sort(size_t first, size_t last){
+  // insertion sort that gives up after moving a handful of items
+  const size_t MOVE_LIMIT = 8;
+  size_t moved = 0;
+  for(size_t i = first+1; i < last; i++){
+    if(items[i] < items[i-1]){
+      T saver = std::move(items[i]);
+      size_t k = i;
+      do{
+        items[k] = std::move(items[k-1]);
+        k--;
+      } while(k > first && saver < items[k-1]);
+      items[k] = std::move(saver);
+      moved += i - k;
+      if(moved > MOVE_LIMIT){
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+template <typename T>
+void ArrayList<T>:: sift_down(size_t first, size_t root, size_t n){
+  for(;;){ // root and its children are offsets from first
+    size_t child = 2*root + 1;
+    if(child >= n){
+      return;
+    }
+    if(child+1 < n && items[first+child] < items[first+child+1]){
+      child++;
+    }
+    if(!(items[first+root] < items[first+child])){
+      return;
+    }
+    swap(first+root, first+child);
+    root = child;
+  }
+}
+
+template <typename T>
+void ArrayList<T>:: heap_sort(size_t first, size_t last){
+  size_t n = last - first;
+  for(size_t i = n/2; i > 0; i--){ // build a max heap
+    sift_down(first, i-1, n);
+  }
+  for(size_t end = n-1; end > 0; end--){ // move the max to the back
+    swap(first, first+end);
+    sift_down(first, 0, end);
+  }
+}
+
+template <typename T>
+void ArrayList<T>:: sort3(size_t a, size_t b, size_t c){
+  // orders items at a, b and c so the median ends up at b
+  if(items[b] < items[a]) swap(a, b);
+  if(items[c] < items[b]) swap(b, c);
+  if(items[b] < items[a]) swap(a, b);
+}
+
+template <typename T>
+void ArrayList<T>:: radix_sort(){
+  if(length < RADIX_SORT_CUTOFF){ // not worth the counting passes
+    sort();
+    return;
+  }
+  radix_sort(typename radix_sort_category<T>::type());
+}
+
+template <typename T>
+void ArrayList<T>:: radix_sort(comparison_sort_tag){
+  sort();
+}
+
+template <typename T>
+void ArrayList<T>:: radix_sort(integer_radix_sort_tag){
+  typedef typename std::make_unsigned<T>::type U;
+  // flipping the sign bit makes signed keys order correctly as unsigned
+  const U flip = std::is_signed<T>::value ? U(U(1) << (8*sizeof(T)-1)) : U(0);
+  T* scratch = allocate(capacity); // integers need no construction
+  T* src = items;
+  T* dst = scratch;
+  size_t counts[256];
+  for(size_t shift=0; shift<8*sizeof(T); shift+=8){ // one pass per byte
+    for(size_t d=0; d<256; d++){
+      counts[d] = 0;
+    }
+    for(size_t i=0; i<length; i++){
+      counts[((U(src[i]) ^ flip) >> shift) & 0xFF]++;
+    }
+    if(counts[((U(src[0]) ^ flip) >> shift) & 0xFF] == length){
+      continue; // every key has the same byte here, nothing to move
+    }
+    size_t total = 0;
+    for(size_t d=0; d<256; d++){ // turn counts into starting offsets
+      size_t c = counts[d];
+      counts[d] = total;
+      total += c;
+    }
+    for(size_t i=0; i<length; i++){
+      dst[counts[((U(src[i]) ^ flip) >> shift) & 0xFF]++] = src[i];
+    }
+    std::swap(src, dst);
+  }
+  if(src != items){ // the result ended up in the scratch array
+    release(items);
+    items = src;
+  }
+  else{
+    deallocate(scratch);
+  }
+}
+
+template <typename T>
+void ArrayList<T>:: radix_sort(string_radix_sort_tag){
+  multikey_quick_sort(0, length, 0);
+}
+
+template <typename T>
+void ArrayList<T>:: multikey_quick_sort(size_t first, size_t last, size_t depth){
+  // every string in [first, last) shares its first depth characters;
+  // a character past the end of a string counts as -1
+  while(last - first > INSERTION_SORT_CUTOFF){
+    size_t mid = first + (last-first)/2;
+    int a = depth < items[first].size() ? (unsigned char)items[first][depth] : -1;
+    int b = depth < items[mid].size() ? (unsigned char)items[mid][depth] : -1;
+    int c = depth < items[last-1].size() ? (unsigned char)items[last-1][depth] : -1;
+    int pivot = (a < b) ? ((b < c) ? b : (a < c ? c : a)) : ((a < c) ? a : (b < c ? c : b));
+    // three way partition on the character at depth
+    size_t lt = first;
+    size_t gt = last;
+    size_t i = first;
+    while(i < gt){
+      int ch = depth < items[i].size() ? (unsigned char)items[i][depth] : -1;
+      if(ch < pivot){
+        swap(lt++, i++);
+      }
+      else if(ch > pivot){
+        swap(i, --gt);
       }
       else{
-        tmp[i++] = items[first2++];
+        i++;
       }
     }
-    while(first1 <= mid){
-      tmp[i++] = items[first1++];
+    // recurse on the equal part and the smaller outer part, loop on the other
+    if(pivot >= 0){
+      multikey_quick_sort(lt, gt, depth+1);
     }
-    while(first2 <= end){
-      tmp[i++] = items[first2++];
+    if(lt - first < last - gt){
+      multikey_quick_sort(first, lt, depth);
+      first = gt;
     }
-    for(int k = start; k<=end; k++ ){
-      items[k] = tmp[k-start];
+    else{
+      multikey_quick_sort(gt, last, depth);
+      last = lt;
     }
+  }
+  insertion_sort(first, last);
+}
 
-  delete[] tmp;
+template <typename T>
+void ArrayList<T>:: merge_sort(){
+  // short runs are insertion sorted first (it is stable as well)
+  for(size_t first=0; first<length; first+=INSERTION_SORT_CUTOFF){
+    size_t last = first + INSERTION_SORT_CUTOFF;
+    insertion_sort(first, last < length ? last : length);
+  }
+  T* scratch = nullptr; // only allocated once a merge is really needed
+  for(size_t width=INSERTION_SORT_CUTOFF; width<length; width*=2){
+    for(size_t lo=0; lo+width<length; lo+=2*width){
+      size_t mid = lo + width;
+      size_t hi = (length - mid > width) ? mid + width : length;
+      if(items[mid] < items[mid-1]){ // runs already in order are skipped
+        if(scratch == nullptr){
+          scratch = allocate(length);
+        }
+        merge_lo(lo, mid, hi, scratch);
+      }
+    }
   }
+  deallocate(scratch);
+};
 
+template <typename T>
+void ArrayList<T>:: merge_lo(size_t lo, size_t mid, size_t hi, T* scratch){
+  // left items no bigger than the first right item are already placed,
+  // as are right items no smaller than the last left item
+  lo += gallop_upper(items[mid], items + lo, mid - lo);
+  hi = mid + gallop_lower(items[mid-1], items + mid, hi - mid);
+  size_t n = mid - lo;
+  for(size_t i=0; i<n; i++){ // the left run moves out of the way
+    new (scratch + i) T(std::move(items[lo+i]));
+  }
+  size_t i = 0;
+  size_t j = mid;
+  size_t k = lo;
+  size_t left_wins = 0;
+  size_t right_wins = 0;
+  while(i < n && j < hi){
+    if(items[j] < scratch[i]){ // ties take the left item to stay stable
+      items[k++] = std::move(items[j++]);
+      right_wins++;
+      left_wins = 0;
+    }
+    else{
+      items[k++] = std::move(scratch[i++]);
+      left_wins++;
+      right_wins = 0;
+    }
+    if(left_wins >= MIN_GALLOP && j < hi){ // one run keeps winning, so
+      size_t count = gallop_upper(items[j], scratch + i, n - i); // jump
+      for(size_t c=0; c<count; c++){
+        items[k++] = std::move(scratch[i++]);
+      }
+      left_wins = 0;
+    }
+    else if(right_wins >= MIN_GALLOP && i < n){
+      size_t count = gallop_lower(scratch[i], items + j, hi - j);
+      for(size_t c=0; c<count; c++){
+        items[k++] = std::move(items[j++]);
+      }
+      right_wins = 0;
+    }
+  }
+  while(i < n){ // leftover right items are already in place
+    items[k++] = std::move(scratch[i++]);
+  }
+  destroy(scratch, n); // scratch goes back to raw for the next merge
+};
+
+template <typename T>
+size_t ArrayList<T>:: gallop_upper(const T& key, const T* run, size_t n){
+  // number of items in run that are <= key, probing 1, 2, 4, ... first
+  size_t bound = 1;
+  while(bound < n && !(key < run[bound])){
+    bound *= 2;
+  }
+  size_t lo = bound/2;
+  size_t hi = (bound < n) ? bound : n;
+  while(lo < hi){
+    size_t m = lo + (hi - lo)/2;
+    if(key < run[m]){
+      hi = m;
+    }
+    else{
+      lo = m + 1;
+    }
+  }
+  return lo;
+};
+
+template <typename T>
+size_t ArrayList<T>:: gallop_lower(const T& key, const T* run, size_t n){
+  // number of items in run that are < key, probing 1, 2, 4, ... first
+  size_t bound = 1;
+  while(bound < n && run[bound] < key){
+    bound *= 2;
+  }
+  size_t lo = bound/2;
+  size_t hi = (bound < n) ? bound : n;
+  while(lo < hi){
+    size_t m = lo + (hi - lo)/2;
+    if(run[m] < key){
+      lo = m + 1;
+    }
+    else{
+      hi = m;
+    }
+  }
+  return lo;
 };
 
 template <typename T>
@@ -129,9 +656,7 @@ void ArrayList<T>:: quick_sort(size_t start, size_t end){
 
 template <typename T>
 void ArrayList<T>:: swap(size_t x, size_t y){ // simple swap function
-  T z = items[x];
-  items[x] = items[y];
-  items[y] = z;
+  std::swap(items[x], items[y]);
 };
 
 template<typename T>
@@ -181,60 +706,336 @@ void ArrayList<T>::insertion_sort(){
 
 template<typename T>
 ArrayList<T>::~ArrayList(){
+  destroy(items, length);
   length = 0;
-  delete [] items;
+  release(items);
   items = nullptr;
 };
 
 template<typename T>
-ArrayList<T>::ArrayList() : capacity(10), length(0)
+ArrayList<T>::ArrayList() : items(nullptr), capacity(0), length(0), inline_buffer(nullptr), inline_capacity(0)
+{
+  // nothing is allocated until the first add
+}
+
+template<typename T>
+ArrayList<T>::ArrayList(T* buffer, size_t n) : items(buffer), capacity(n), length(0), inline_buffer(buffer), inline_capacity(n)
 {
-  items = new T[capacity];
 }
 
 template<typename T>
 ArrayList<T>& ArrayList<T> :: operator=(const ArrayList<T>& rhs){
 if(this != &rhs){ // list1= list1
-  capacity = rhs.capacity;
-  items = new T[capacity]; // creating new array
-  length=0;
-    for(int i=0; i<rhs.size(); i++){ // moving items
-      items[i] = rhs.items[i];
-      length++;
-    }
-    length = rhs.size(); // moving size
+  destroy(items, length);
+  length = 0;
+  if(rhs.length > capacity){ // current array too small, creating new array
+    release(items); // release the old array
+    capacity = rhs.capacity;
+    items = allocate(capacity);
+  }
+  copy_construct(items, rhs.items, rhs.length); // copying items
+  length = rhs.size(); // moving size
   }
   //return lhs(this)
   return *this;
 }
 
 template<typename T>
-ArrayList<T>::ArrayList(const ArrayList<T>& rhs) : capacity(10), length(0), items(nullptr)
+ArrayList<T>::ArrayList(const ArrayList<T>& rhs) : items(nullptr), capacity(0), length(0), inline_buffer(nullptr), inline_capacity(0)
 {
   // defer to assignment operator
   *this = rhs;
 }
 
+template<typename T>
+ArrayList<T>::ArrayList(ArrayList<T>&& rhs) : items(nullptr), capacity(0), length(0), inline_buffer(nullptr), inline_capacity(0)
+{
+  take(rhs);
+}
 
-// TODO: Finish the remaining functions below
 template<typename T>
- void ArrayList<T>:: resize(){
-    capacity = capacity*2; // double size
-    T* ptr = new T [capacity];
-    for(int i = 0; i< length; i++){ //move
-      ptr[i] = items[i];
+ArrayList<T>& ArrayList<T> :: operator=(ArrayList<T>&& rhs){
+  if(this != &rhs){
+    destroy(items, length);
+    length = 0;
+    release(items);
+    items = inline_buffer;
+    capacity = inline_capacity;
+    take(rhs);
+  }
+  return *this;
+}
+
+template<typename T>
+void ArrayList<T>:: take(ArrayList<T>& rhs){
+  if(!rhs.using_inline() && (inline_capacity == 0 || rhs.length > inline_capacity)){ // steal rhs's array
+    release(items);
+    items = rhs.items;
+    capacity = rhs.capacity;
+    rhs.items = nullptr;
+    rhs.capacity = 0;
+  }
+  else{ // rhs's items are inline (or fit in ours), so they have to move
+    if(rhs.length > capacity){
+      reallocate(rhs.length);
+    }
+    relocate(items, rhs.items, rhs.length);
+  }
+  length = rhs.length;
+  rhs.length = 0;
+  if(rhs.items == nullptr){ // rhs falls back on its own inline buffer
+    rhs.items = rhs.inline_buffer;
+    rhs.capacity = rhs.inline_capacity;
+  }
+}
+
+template<typename T>
+bool ArrayList<T>:: using_inline() const{
+  return items != nullptr && items == inline_buffer;
+}
+
+template<typename T>
+void ArrayList<T>:: release(T* ptr){
+  if(ptr != inline_buffer){
+    deallocate(ptr);
+  }
+}
+
+template<typename T>
+void ArrayList<T>:: clear(){
+  destroy(items, length); // a no-op for trivially destructible items
+  length = 0;
+}
+
+template<typename T>
+void ArrayList<T>:: reserve(size_t n){
+  if(n > capacity){
+    reallocate(n);
+  }
+}
+
+template<typename T>
+void ArrayList<T>:: shrink_to_fit(){
+  if(length < capacity){
+    reallocate(length);
+  }
+}
+
+template<typename T>
+T* ArrayList<T>:: allocate(size_t n){
+  // raw memory only, slots are constructed as items are added
+  return (n > 0) ? static_cast<T*>(::operator new(n*sizeof(T))) : nullptr;
+}
+
+template<typename T>
+void ArrayList<T>:: deallocate(T* ptr){
+  ::operator delete(ptr);
+}
+
+template<typename T>
+void ArrayList<T>:: destroy(T* first, size_t n){
+  if(!std::is_trivially_destructible<T>::value){
+    for(size_t i=0; i<n; i++){
+      first[i].~T();
+    }
+  }
+}
+
+template<typename T>
+void ArrayList<T>:: relocate(T* dst, T* src, size_t n){
+  // dst is raw and src[0, n) is left raw afterwards
+  relocate(dst, src, n, trivial_tag());
+}
+
+template<typename T>
+void ArrayList<T>:: relocate(T* dst, T* src, size_t n, std::true_type){
+  if(n > 0){
+    std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), n*sizeof(T));
+  }
+}
+
+template<typename T>
+void ArrayList<T>:: relocate(T* dst, T* src, size_t n, std::false_type){
+  for(size_t i=0; i<n; i++){
+    new (dst + i) T(std::move(src[i]));
+    src[i].~T();
+  }
+}
+
+template<typename T>
+void ArrayList<T>:: copy_construct(T* dst, const T* src, size_t n){
+  copy_construct(dst, src, n, trivial_tag());
+}
+
+template<typename T>
+void ArrayList<T>:: copy_construct(T* dst, const T* src, size_t n, std::true_type){
+  if(n > 0){
+    std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), n*sizeof(T));
+  }
+}
+
+template<typename T>
+void ArrayList<T>:: copy_construct(T* dst, const T* src, size_t n, std::false_type){
+  for(size_t i=0; i<n; i++){
+    new (dst + i) T(src[i]);
+  }
+}
+
+template<typename T>
+void ArrayList<T>:: open_gap(size_t index, std::true_type){
+  std::memmove(static_cast<void*>(items + index + 1), static_cast<const void*>(items + index),
+               (length - index)*sizeof(T));
+}
+
+template<typename T>
+void ArrayList<T>:: open_gap(size_t index, std::false_type){
+  // the last item moves into raw memory, the rest shift by assignment,
+  // and the slot at index is left raw
+  new (items + length) T(std::move(items[length-1]));
+  for(size_t i=length-1; i>index; i--){
+    items[i] = std::move(items[i-1]);
+  }
+  items[index].~T();
+}
+
+template<typename T>
+void ArrayList<T>:: close_gap(size_t index, std::true_type){
+  std::memmove(static_cast<void*>(items + index), static_cast<const void*>(items + index + 1),
+               (length - index - 1)*sizeof(T));
+}
+
+template<typename T>
+void ArrayList<T>:: close_gap(size_t index, std::false_type){
+  for(size_t i=index; i+1<length; i++){ // shift everything down by one
+    items[i] = std::move(items[i+1]);
+  }
+  items[length-1].~T();
+}
+
+template<typename T>
+void ArrayList<T>:: append(const T* first, size_t n){
+  if(n == 0){
+    return;
+  }
+  if(owns(*first) && length + n > capacity){ // growing would free the source
+    ArrayList<T> saver;
+    saver.append(first, n);
+    append(saver.items, n);
+    return;
+  }
+  grow_to(length + n);
+  copy_construct(items + length, first, n);
+  length += n;
+}
+
+template<typename T>
+bool ArrayList<T>:: insert(size_t index, const T* first, size_t n){
+  if(index > length){
+    return false;
+  }
+  if(n == 0){
+    return true;
+  }
+  if(owns(*first)){ // the source would move along with the tail
+    ArrayList<T> saver;
+    saver.append(first, n);
+    return insert(index, saver.items, n);
+  }
+  grow_to(length + n);
+  // the tail moves back n slots in one pass (last item first), leaving
+  // a raw gap for the new items
+  if(trivial_tag::value){
+    std::memmove(static_cast<void*>(items + index + n), static_cast<const void*>(items + index),
+                 (length - index)*sizeof(T));
+  }
+  else{
+    for(size_t i=length; i>index; i--){
+      relocate(items + i - 1 + n, items + i - 1, 1);
     }
-    delete [] items; // delete old
+  }
+  copy_construct(items + index, first, n);
+  length += n;
+  return true;
+}
+
+template<typename T>
+bool ArrayList<T>:: erase(size_t first, size_t last){
+  if(first > last || last > length){
+    return false;
+  }
+  size_t n = last - first;
+  if(n == 0){
+    return true;
+  }
+  if(trivial_tag::value){
+    std::memmove(static_cast<void*>(items + first), static_cast<const void*>(items + last),
+                 (length - last)*sizeof(T));
+  }
+  else{
+    for(size_t i=last; i<length; i++){ // shift the tail down once
+      items[i-n] = std::move(items[i]);
+    }
+    destroy(items + length - n, n);
+  }
+  length -= n;
+  return true;
+}
+
+template<typename T>
+T* ArrayList<T>:: data(){
+  return items;
+}
+
+template<typename T>
+const T* ArrayList<T>:: data() const{
+  return items;
+}
+
+template<typename T>
+void ArrayList<T>:: grow_to(size_t n){
+  if(n > capacity){
+    size_t doubled = (capacity > 0) ? capacity*2 : 10;
+    reallocate(n > doubled ? n : doubled);
+  }
+}
+
+template<typename T>
+bool ArrayList<T>:: owns(const T& item) const{
+  std::less<const T*> before;
+  return !before(&item, items) && before(&item, items + length);
+}
+
+template<typename T>
+void ArrayList<T>:: reallocate(size_t n){
+  T* ptr = (n <= inline_capacity) ? inline_buffer : allocate(n); // back inline if it fits
+  if(ptr != items){
+    relocate(ptr, items, length); // move, not copy, into the new array
+    release(items);
     items = ptr;
-    ptr = nullptr;
+  }
+  capacity = (ptr == inline_buffer) ? inline_capacity : n;
+}
+
+
+// TODO: Finish the remaining functions below
+template<typename T>
+ void ArrayList<T>:: resize(){
+    reallocate((capacity > 0) ? capacity*2 : 10); // double size (moved-from lists have none)
   };
 
 template<typename T>
  void ArrayList<T>:: add(const T& item){
    if(length==capacity){ //resize if at capacity
+     if(owns(item)){ // growing would free the storage item lives in
+       T saver(item);
+       resize();
+       new (items + length) T(std::move(saver));
+       length++;
+       return;
+     }
      resize();
    }
-     items[length] = item; // add to end
+     new (items + length) T(item); // add to end
      length++;
  };
 
@@ -244,21 +1045,17 @@ template<typename T>
    if(index >= length) { // check for valid index
      return false;
    } 
+   if(owns(item)){ // shifting (or growing) would move item out from under us
+     T saver(item);
+     return add(index, saver);
+   }
    if(length == capacity){ // check for resize
      resize();
    }
-//    if(index == length-1) { //check if adding to end
-//      add(item);
-//      return true;
-//    }
-   //else{
-     for(int i=length; i>index ; i--){
-        items[i] = items[i-1];//shifting over
-     }
-     items[index] = item; //inserting item
-     length++;
-     return true;
-   //}
+   open_gap(index, trivial_tag()); //shifting over
+   new (items + index) T(item); //inserting item
+   length++;
+   return true;
  };
 
 template<typename T>
@@ -292,12 +1089,7 @@ template<typename T>
      return false;
    }
    else{
-     for(int i=index; i<length-1 ; i++){//shift everyting down by one and cover up index, deleting it
-       if(i+1 > capacity){ // if reaching over the edge of array
-         resize();
-        }
-        items[i] = items[i+1];
-      }
+     close_gap(index, trivial_tag()); //shift everyting down by one and cover up index, deleting it
      length--;
      return true;
    }
@@ -8,7 +8,9 @@
 //       it. Find give the value of a given key and returns true if found.
 //       Find range gives the all the keys in between 2 keys.
 //       keys gives all the keys. Sort give a sorted list of all the keys
-//       using quick sort
+//       using quick sort. Keys and values are kept in separate arrays so
+//       searches scan a contiguous key array; 32 and 64 bit integer keys
+//       are compared several at a time with SSE2/AVX2 when available.
 //----------------------------------------------------------------------
 
 #ifndef ARRAY_LIST_COLLECTION_H
@@ -16,7 +18,24 @@
 
 #include "array_list.h"
 #include "collection.h"
+#include <type_traits>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// key searches pick a scan at compile time from these tags
+struct scalar_key_search_tag {};
+struct simd32_key_search_tag {};
+struct simd64_key_search_tag {};
+
+template<typename K, bool = std::is_integral<K>::value, size_t = sizeof(K)>
+struct key_search_category { typedef scalar_key_search_tag type; };
 
+template<typename K>
+struct key_search_category<K,true,4> { typedef simd32_key_search_tag type; };
+
+template<typename K>
+struct key_search_category<K,true,8> { typedef simd64_key_search_tag type; };
 
 
 template<typename K, typename V>
@@ -26,6 +45,9 @@ public:
   // add a new key-value pair into the collection 
     void add(const K& a_key, const V& a_val);
 
+  // add n new key-value pairs at once
+    void add(const std::pair<K,V>* pairs, size_t n);
+
   // remove a key-value pair from the collection
     void remove(const K& a_key);
 
@@ -45,56 +67,62 @@ public:
   // return the number of key-value pairs in the collection
     size_t size() const;
 
-  ArrayList<std::pair<K,V>> kv_list;
+private:
+  // the i-th key goes with the i-th value
+  ArrayList<K> key_list;
+  ArrayList<V> val_list;
+
+    // index of key in keys[0, n), or n if it is not there
+    static size_t linear_search(const K* keys, size_t n, const K& key);
+    static size_t linear_search(const K* keys, size_t n, const K& key, scalar_key_search_tag);
+    static size_t linear_search(const K* keys, size_t n, const K& key, simd32_key_search_tag);
+    static size_t linear_search(const K* keys, size_t n, const K& key, simd64_key_search_tag);
 
 };
 
 template<typename K, typename V>
  void ArrayListCollection<K,V>:: add(const K& a_key, const V& a_val){
-   std::pair<K,V> a;
-   a = std::make_pair(a_key, a_val);
-   kv_list.add(a); // adds pair to end of the array list
+   key_list.add(a_key); // adds pair to end of the array lists
+   val_list.add(a_val);
+ };
+
+template<typename K, typename V>
+ void ArrayListCollection<K,V>:: add(const std::pair<K,V>* pairs, size_t n){
+   key_list.reserve(key_list.size() + n); // one growth for the batch
+   val_list.reserve(val_list.size() + n);
+   for(size_t i = 0; i<n; i++){
+     key_list.add(pairs[i].first);
+     val_list.add(pairs[i].second);
+   }
  };
 
  template<typename K, typename V>
  void ArrayListCollection<K,V>:: remove(const K& a_key){
-   if((size() > 0)){
-     for(int i = 0; i<kv_list.size(); i++){ // iterate throught the list
-       std::pair<K,V> a;
-         kv_list.get(i,a);
-       if(a_key == a.first){ // check each item if it the the key
-         kv_list.remove(i); // remove if it is found
-       }
-     }
+   size_t i = linear_search(key_list.data(), key_list.size(), a_key);
+   if(i < key_list.size()){ // remove if it is found
+     key_list.erase(i, i+1);
+     val_list.erase(i, i+1);
    }
  };
 
  template<typename K, typename V>
  bool ArrayListCollection<K,V>:: find(const K& search_key, V& the_val) const{
-   if(size() > 0){
-     for(int i = 0; i<kv_list.size(); i++){ //iterate through the list
-       std::pair<K,V> a;
-       kv_list.get(i,a);
-       if(search_key == a.first){ // check each item to find the key
-         the_val = a.second; // return the value of the key if found
-         return true;
-       }
-     }
+   size_t i = linear_search(key_list.data(), key_list.size(), search_key);
+   if(i < key_list.size()){
+     the_val = val_list.data()[i]; // return the value of the key if found
+     return true;
    }
-     return false; //if not found return false
+   return false; //if not found return false
  };
 
  template<typename K, typename V>
  void ArrayListCollection<K,V>:: find(const K& k1, const K& k2, ArrayList<K>& keys) const{
+   keys.clear(); // make sure the list is empty
    if((k2 >= k1) && (size() > 0)){
-     while(keys.size()>0){ // make sure the list is empty
-       keys.remove(0);
-      }
-     for(int i = 0; i<kv_list.size(); i++){ //search the list fore the first key
-       std::pair<K,V> a;
-       kv_list.get(i,a);
-       if((a.first >= k1) && (a.first <= k2)){
-         keys.add(a.first); // add all keys after the first key is found
+     const K* all = key_list.data();
+     for(size_t i = 0; i<key_list.size(); i++){ //check every key in place
+       if((all[i] >= k1) && (all[i] <= k2)){
+         keys.add(all[i]);
        }
      }
    }
@@ -102,33 +130,109 @@ template<typename K, typename V>
 
 template<typename K, typename V>
  void ArrayListCollection<K,V>:: keys(ArrayList<K>& all_keys) const{
-     if((size() > 0)){
-       while(all_keys.size()>0){
-       all_keys.remove(0);
-      }
-     for(int i = 0; i<kv_list.size(); i++){  // add all keys to the list starting from the beginning
-       std::pair<K,V> a;
-        kv_list.get(i,a);
-        all_keys.add(a.first);
-     }
-   }
+     all_keys.clear();
+     all_keys.append(key_list.data(), key_list.size()); // the keys are already one array
  };
 
  template<typename K, typename V>
  void ArrayListCollection<K,V>:: sort(ArrayList<K>& all_keys_sorted) const{
-    if((size() > 0)){
-      while(all_keys_sorted.size()>0){
-       all_keys_sorted.remove(0); // make list empty
-      }
      keys(all_keys_sorted); // get all the keys from the list
      all_keys_sorted.sort(); // quick sort the list and return the list sorted
-   }
  };
 
  template<typename K, typename V>
  size_t ArrayListCollection<K,V>:: size() const{
-     return kv_list.size();
+     return key_list.size();
  };
 
+template<typename K, typename V>
+size_t ArrayListCollection<K,V>:: linear_search(const K* keys, size_t n, const K& key){
+  return linear_search(keys, n, key, typename key_search_category<K>::type());
+};
+
+template<typename K, typename V>
+size_t ArrayListCollection<K,V>:: linear_search(const K* keys, size_t n, const K& key, scalar_key_search_tag){
+  for(size_t i = 0; i<n; i++){ // check each key in turn
+    if(keys[i] == key){
+      return i;
+    }
+  }
+  return n;
+};
+
+template<typename K, typename V>
+size_t ArrayListCollection<K,V>:: linear_search(const K* keys, size_t n, const K& key, simd32_key_search_tag){
+  size_t i = 0;
+#if defined(__AVX2__)
+  // 16 keys per step, each compare sets 4 mask bits per matching key
+  __m256i needle = _mm256_set1_epi32((int)key);
+  for(; i+16 <= n; i+=16){
+    __m256i a = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(keys + i)), needle);
+    __m256i b = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(keys + i + 8)), needle);
+    if(_mm256_movemask_epi8(_mm256_or_si256(a, b)) != 0){ // only build the mask on a hit
+      unsigned long long mask = (unsigned)_mm256_movemask_epi8(a)
+        | ((unsigned long long)(unsigned)_mm256_movemask_epi8(b) << 32);
+      return i + __builtin_ctzll(mask)/4;
+    }
+  }
+#elif defined(__SSE2__)
+  // 16 keys per step, each compare sets 4 mask bits per matching key
+  __m128i needle = _mm_set1_epi32((int)key);
+  for(; i+16 <= n; i+=16){
+    __m128i e0 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(keys + i)), needle);
+    __m128i e1 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(keys + i + 4)), needle);
+    __m128i e2 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(keys + i + 8)), needle);
+    __m128i e3 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(keys + i + 12)), needle);
+    if(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(e0, e1), _mm_or_si128(e2, e3))) != 0){
+      unsigned long long mask = (unsigned long long)_mm_movemask_epi8(e0)
+        | ((unsigned long long)_mm_movemask_epi8(e1) << 16)
+        | ((unsigned long long)_mm_movemask_epi8(e2) << 32)
+        | ((unsigned long long)_mm_movemask_epi8(e3) << 48);
+      return i + __builtin_ctzll(mask)/4;
+    }
+  }
+#endif
+  size_t rest = linear_search(keys + i, n - i, key, scalar_key_search_tag());
+  return i + rest;
+};
+
+template<typename K, typename V>
+size_t ArrayListCollection<K,V>:: linear_search(const K* keys, size_t n, const K& key, simd64_key_search_tag){
+  size_t i = 0;
+#if defined(__AVX2__)
+  // 8 keys per step, each compare sets 8 mask bits per matching key
+  __m256i needle = _mm256_set1_epi64x((long long)key);
+  for(; i+8 <= n; i+=8){
+    __m256i a = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(keys + i)), needle);
+    __m256i b = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(keys + i + 4)), needle);
+    if(_mm256_movemask_epi8(_mm256_or_si256(a, b)) != 0){ // only build the mask on a hit
+      unsigned long long mask = (unsigned)_mm256_movemask_epi8(a)
+        | ((unsigned long long)(unsigned)_mm256_movemask_epi8(b) << 32);
+      return i + __builtin_ctzll(mask)/8;
+    }
+  }
+#elif defined(__SSE2__)
+  // 8 keys per step; SSE2 has no 64 bit compare, so both 32 bit halves
+  // have to match
+  __m128i needle = _mm_set1_epi64x((long long)key);
+  for(; i+8 <= n; i+=8){
+    __m128i eq[4];
+    for(size_t v = 0; v<4; v++){
+      __m128i e = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(keys + i + 2*v)), needle);
+      eq[v] = _mm_and_si128(e, _mm_shuffle_epi32(e, _MM_SHUFFLE(2,3,0,1)));
+    }
+    if(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(eq[0], eq[1]), _mm_or_si128(eq[2], eq[3]))) != 0){
+      unsigned long long mask = 0;
+      for(size_t v = 0; v<4; v++){
+        mask |= (unsigned long long)_mm_movemask_epi8(eq[v]) << (16*v);
+      }
+      return i + __builtin_ctzll(mask)/8;
+    }
+  }
+#endif
+  size_t rest = linear_search(keys + i, n - i, key, scalar_key_search_tag());
+  return i + rest;
+};
+
 
 #endif
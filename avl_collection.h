@@ -6,7 +6,14 @@
 //       class. Includes all member function inherited from collection
 //       as well as the constructor, destructor, copy constructor, and
 //       assignment operator and height function. This tree data structure
-//       uses roatations to keep the tree balanced and efficient
+//       uses roatations to keep the tree balanced and efficient.
+//       add and remove walk down once, remembering the links they
+//       passed in a fixed size path stack, then climb back up fixing
+//       heights and rotating, and stop as soon as a subtree's height
+//       comes out unchanged since nothing above it can change either.
+//       Nodes keep a balance factor (right height minus left height,
+//       -1, 0 or +1) in the two low bits of the left pointer instead
+//       of a height, which nodes are aligned well enough to leave free.
 //----------------------------------------------------------------------
 
 
@@ -16,6 +23,7 @@
 #include "array_list.h"
 #include "collection.h"
 #include <functional>
+#include <cstdint>
 
 template<typename K, typename V>
 class AVLCollection : public Collection<K,V>
@@ -58,19 +66,31 @@ public:
     //tree height function
     size_t height() const;
 
+    // check that keys are in order, stored balance factors are right and
+    // every node is balanced (for testing)
+    bool valid_avl() const;
+
 
 
 //private:
 
-    //tree node
+    //tree node: the left child and the balance factor (plus one, so
+    //0, 1 or 2) share a word, use the helpers below to read or set them
     struct Node{
         K key;
         V value;
-        int height;
-        Node* left;
+        uintptr_t left_and_balance;
         Node* right;
     };
 
+    // low pointer bits holding the balance factor
+    static const uintptr_t BALANCE_MASK = 3;
+
+    static Node* left_of(const Node* n);
+    static void set_left(Node* n, Node* left);
+    static int balance_of(const Node* n);
+    static void set_balance(Node* n, int balance);
+
     // root node of the tree
     Node* root;
 
@@ -83,46 +103,91 @@ public:
     //copy helper 
     void copy (Node* lhs_subtree_root, const Node* rhs_subtree_root);
 
-    // remove helper
-    Node* remove(Node* subtree_root, const K& a_key);
-
     //helper function to recursively build up key list
     void find(const Node* subtree_root, const K& k1, const K& k2, ArrayList<K>& keys)const;
 
     //helper to recursivley build sorted list of keys
     void keys(const Node* subtree_root, ArrayList<K>& all_keys)const;
 
-    //helper to recursively find height of the tree
+    //helper to find the height of a subtree by following its taller side
     size_t height(const Node* subtree_root)const;
 
     //new to hw 8
 
-    // add helper
+    // nodes on the way down from the root, and which way the walk went
+    // from each (-1 left, +1 right); an AVL tree of 2^64 nodes is less
+    // than 1.44*64 levels tall, so this never overflows
+    static const size_t MAX_PATH = 96;
 
-    Node* add(Node* subtree_root, const K& key, const V& val);
+    // replace parent's child on the given side (the root if parent is null)
+    void set_child(Node* parent, int dir, Node* child);
 
-    //rotate right helper 
-    Node* rotate_right(Node* k2);
+    //rotate right helper (links only, callers fix the balance factors)
+    static Node* rotate_right(Node* k2);
 
-    // rotate left helper
-    Node* rotate_left(Node* k2);
+    // rotate left helper (links only)
+    static Node* rotate_left(Node* k2);
 
-    //rebalance the subtree rooted at subree_root
-    Node* rebalance(Node* subtree_root);
+    // rotate a subtree whose balance factor has reached -2 or +2 and fix
+    // the balance factors, returns the new root; its balance factor is
+    // 0 unless the subtree kept its height (which only a remove allows)
+    static Node* rebalance(Node* subtree_root, int balance);
 
-    //helper for rebalance to make sure heights are correct
-    Node* updateheight(Node* subtree_root);
+    // update balance factors from path[depth-1] up after the subtree on
+    // side dirs[depth-1] grew (add) or shrank (remove), stopping once a
+    // subtree's height is unchanged
+    void retrace_add(Node* path[], const signed char dirs[], size_t depth);
+    void retrace_remove(Node* path[], const signed char dirs[], size_t depth);
+
+    // validate helper: height of the subtree, or -1 if it is not a
+    // valid AVL tree with keys in [lo, hi] (where given)
+    int valid_avl(const Node* subtree_root, const K* lo, const K* hi, size_t& count) const;
 
     // for testing
     void print_tree(std::string indent, Node* subtree_root);
 
 };
 
+template<typename K, typename V>
+typename AVLCollection<K,V>::Node*
+AVLCollection<K,V>::left_of(const Node* n){
+  return reinterpret_cast<Node*>(n->left_and_balance & ~BALANCE_MASK);
+};
+
+template<typename K, typename V>
+void AVLCollection<K,V>::set_left(Node* n, Node* left){
+  static_assert(alignof(Node) > BALANCE_MASK, "node pointers need two free low bits");
+  n->left_and_balance = reinterpret_cast<uintptr_t>(left) | (n->left_and_balance & BALANCE_MASK);
+};
+
+template<typename K, typename V>
+int AVLCollection<K,V>::balance_of(const Node* n){
+  return (int)(n->left_and_balance & BALANCE_MASK) - 1;
+};
+
+template<typename K, typename V>
+void AVLCollection<K,V>::set_balance(Node* n, int balance){
+  n->left_and_balance = (n->left_and_balance & ~BALANCE_MASK) | (uintptr_t)(balance + 1);
+};
+
+template<typename K, typename V>
+void AVLCollection<K,V>::set_child(Node* parent, int dir, Node* child){
+  if(parent == nullptr){
+    root = child;
+  }
+  else if(dir < 0){
+    set_left(parent, child);
+  }
+  else{
+    parent->right = child;
+  }
+};
+
 template<typename K, typename V>
 typename AVLCollection<K,V>::Node*
 AVLCollection<K,V>::rotate_right(Node* k2){ //simple right rotation
-  Node* k1 = k2->left;
-  k2->left = k1->right;
+  Node* k1 = left_of(k2);
+  set_left(k2, k1->right);
   k1->right = k2;
   return k1; 
 };
@@ -131,85 +196,107 @@ template<typename K, typename V>
 typename AVLCollection<K,V>::Node*
 AVLCollection<K,V>::rotate_left(Node* k2){ //simple left rotation
   Node* k1 = k2->right;
-  k2->right = k1->left;
-  k1->left = k2;
+  k2->right = left_of(k1);
+  set_left(k1, k2);
   return k1;
 };
 
 template<typename K, typename V>
 typename AVLCollection<K,V>::Node*
-AVLCollection<K,V>::rebalance(Node* subtree_root){
-    if(subtree_root == nullptr){
-      return subtree_root;
-    }
-    Node* lptr = subtree_root->left;
-    Node* rptr = subtree_root->right;
-
-    //left but no right pointer(special case)
-    if(lptr != nullptr && rptr == nullptr && lptr->height >1){
-      if(lptr->right != nullptr && lptr->left == nullptr ){//checking for double rotation
-        subtree_root->left = rotate_left(lptr);
-        lptr = subtree_root->left;
-        lptr->left->height = 1;// updating height
-        lptr->height = lptr->left->height+1;
+AVLCollection<K,V>::rebalance(Node* subtree_root, int balance){
+    int dir = balance > 0 ? 1 : -1; // the heavy side
+    Node* child = dir > 0 ? subtree_root->right : left_of(subtree_root);
+    int child_balance = balance_of(child);
+    if(child_balance == -dir){ // heavy on the inside: double rotation
+      Node* grandchild = dir > 0 ? left_of(child) : child->right;
+      int g = balance_of(grandchild);
+      if(dir > 0){
+        subtree_root->right = rotate_right(child);
       }
-      subtree_root = rotate_right(subtree_root);
-      subtree_root->height = subtree_root->left->height +1; //updating height
-      subtree_root->right->height = 1;// we know that if C is null, be must be null as well to be in this case
-      //subtree_root->right->height = subtree_root->right->right->height +1; // if rptr not null
-      root = subtree_root;
-    }
-    else if(rptr != nullptr && lptr == nullptr && rptr->height >1 ){//right but no left pointer (special case)
-      if(rptr->left != nullptr && rptr->right == nullptr ){//checking for double rotation
-        subtree_root->right = rotate_right(rptr);
-        rptr = subtree_root->right;
-        rptr->right->height = 1;//updating height
-        rptr->height = rptr->right->height+1;// updating height
+      else{
+        set_left(subtree_root, rotate_left(child));
       }
-      subtree_root = rotate_left(subtree_root);
-      subtree_root->height = subtree_root->right->height +1; //updating height
-      subtree_root->left->height = 1;
-      root = subtree_root;
+      Node* new_root = dir > 0 ? rotate_left(subtree_root) : rotate_right(subtree_root);
+      set_balance(subtree_root, g == dir ? -dir : 0);
+      set_balance(child, g == -dir ? dir : 0);
+      set_balance(new_root, 0);
+      return new_root;
     }
-    else if(rptr != nullptr && lptr != nullptr && lptr->height > rptr->height+1){ // left heavy: left right and left left
-      if((lptr->left == nullptr && lptr->right != nullptr) || lptr->right != nullptr && lptr->left != nullptr && lptr->right->height > lptr->left->height ){//checking for double rotation with 2 nodes
-        subtree_root->left = rotate_left(lptr); // left right
-        if(lptr->left != nullptr){ //updating lptr and handling special case of only having right node
-          lptr->height = lptr->left->height+1; // left and maybe right child
-        }
-        else if( lptr->right != nullptr){ // only right child
-          lptr->height = lptr->right->height+1;
-        }
-        else{ // no children
-          lptr->height =1;
-        }
-        lptr = subtree_root->left; // updating lptr
-        lptr->height = lptr->left->height+1;
-      } //left left case
-      subtree_root = rotate_right(subtree_root);
-      subtree_root->height = subtree_root->left->height +1; //updating height
-      subtree_root->right->height = subtree_root->right->right->height +1; // if rptr not null
+    Node* new_root = dir > 0 ? rotate_left(subtree_root) : rotate_right(subtree_root);
+    if(child_balance == 0){ // only after a remove: the height stays the same
+      set_balance(subtree_root, dir);
+      set_balance(new_root, -dir);
     }
-    else if(lptr != nullptr && rptr != nullptr && rptr->height > lptr->height+1){ // right heavy
-      if((rptr->right == nullptr && rptr->left != nullptr) || rptr->left != nullptr && rptr->right != nullptr && rptr->left->height > rptr->right->height ){//checking for double rotation with 2 nodes
-        subtree_root->right = rotate_right(rptr);//right left case
-        if(rptr->right != nullptr){ //right and makybe left
-          rptr->height = rptr->right->height+1;
-        }
-        else if( rptr->left != nullptr){ // only left
-          rptr->height = rptr->left->height+1;
-        }
-        else{ //none
-          rptr->height =1;
-        }
-        rptr = subtree_root->right; // updating rptr
-        rptr->height = rptr->right->height+1;
-      }
-      subtree_root = rotate_left(subtree_root);
-      subtree_root->height = subtree_root->right->height +1; //updating height
-      subtree_root->left->height = subtree_root->left->left->height +1; // if rptr not null
+    else{
+      set_balance(subtree_root, 0);
+      set_balance(new_root, 0);
+    }
+    return new_root;
+};
+
+template<typename K, typename V>
+void AVLCollection<K,V>::retrace_add(Node* path[], const signed char dirs[], size_t depth){
+  while(depth > 0){
+    --depth;
+    Node* subtree_root = path[depth];
+    int balance = balance_of(subtree_root) + dirs[depth];
+    if(balance == 0){ // the shorter side caught up, the height is unchanged
+      set_balance(subtree_root, 0);
+      return;
+    }
+    if(balance == 1 || balance == -1){ // one side grew, so this subtree grew too
+      set_balance(subtree_root, balance);
+      continue;
     }
-    return subtree_root;
+    // a rotation brings the subtree back to its old height
+    set_child(depth > 0 ? path[depth - 1] : nullptr, depth > 0 ? dirs[depth - 1] : 0, rebalance(subtree_root, balance));
+    return;
+  }
+};
+
+template<typename K, typename V>
+void AVLCollection<K,V>::retrace_remove(Node* path[], const signed char dirs[], size_t depth){
+  while(depth > 0){
+    --depth;
+    Node* subtree_root = path[depth];
+    int balance = balance_of(subtree_root) - dirs[depth];
+    if(balance == 1 || balance == -1){ // was even, the other side still holds the height
+      set_balance(subtree_root, balance);
+      return;
+    }
+    if(balance == 0){ // the taller side shrank, so this subtree shrank too
+      set_balance(subtree_root, 0);
+      continue;
+    }
+    Node* new_root = rebalance(subtree_root, balance);
+    set_child(depth > 0 ? path[depth - 1] : nullptr, depth > 0 ? dirs[depth - 1] : 0, new_root);
+    if(balance_of(new_root) != 0){ // the rotation kept the height
+      return;
+    }
+  }
+};
+
+template<typename K, typename V>
+bool AVLCollection<K,V>::valid_avl() const{
+  size_t count = 0;
+  return valid_avl(root, nullptr, nullptr, count) >= 0 && count == node_count;
+};
+
+template<typename K, typename V>
+int AVLCollection<K,V>::valid_avl(const Node* subtree_root, const K* lo, const K* hi, size_t& count) const{
+  if(subtree_root == nullptr){
+    return 0;
+  }
+  count++;
+  if((lo != nullptr && subtree_root->key < *lo) || (hi != nullptr && *hi < subtree_root->key)){
+    return -1;
+  }
+  int lh = valid_avl(left_of(subtree_root), lo, &subtree_root->key, count);
+  int rh = valid_avl(subtree_root->right, &subtree_root->key, hi, count);
+  if(lh < 0 || rh < 0 || rh - lh != balance_of(subtree_root)){ // also catches |rh - lh| > 1
+    return -1;
+  }
+  return (lh > rh ? lh : rh) + 1;
 };
 
 
@@ -218,9 +305,9 @@ void AVLCollection<K,V>:: print_tree(std::string indent, Node* subtree_root){ //
     if(!subtree_root){
         return;
     }
-    std::cout << indent << subtree_root->key << " (h="
-              << subtree_root->height << ")" << std::endl;
-    print_tree(indent + "  ", subtree_root->left);
+    std::cout << indent << subtree_root->key << " (b="
+              << balance_of(subtree_root) << ")" << std::endl;
+    print_tree(indent + "  ", left_of(subtree_root));
     print_tree(indent + "  ", subtree_root->right);
 }
 
@@ -256,11 +343,13 @@ AVLCollection<K,V>& AVLCollection<K,V>::operator=(const AVLCollection<K,V>& rhs)
 if(this != &rhs){ // tree1 != tree1
   if(root != nullptr){
     make_empty(root);
+    root = nullptr;
   }
+  node_count = 0;
   if(rhs.size() >0){
   node_count = 1;
   root = new Node; //set root to something
-  root->left = nullptr;
+  root->left_and_balance = 1; // no left child, balanced
   root->right = nullptr;
   copy(root, rhs.root);
   }
@@ -272,7 +361,7 @@ if(this != &rhs){ // tree1 != tree1
 template<typename K, typename V>
 size_t AVLCollection<K,V>::height()const{
   if(root != nullptr){
-    return root->height;
+    return height(root);
   }
   return 0;
 
@@ -281,7 +370,7 @@ size_t AVLCollection<K,V>::height()const{
 template<typename K, typename V>
 void AVLCollection<K,V>::make_empty(Node* subtree_root){
   if(subtree_root != nullptr){
-    make_empty(subtree_root->left);
+    make_empty(left_of(subtree_root));
     make_empty(subtree_root->right);
     delete subtree_root;
     node_count--;
@@ -296,18 +385,18 @@ void AVLCollection<K,V>::copy (Node* lhs_subtree_root, const Node* rhs_subtree_r
   else {
     lhs_subtree_root->key = rhs_subtree_root->key;
     lhs_subtree_root->value = rhs_subtree_root->value;
+    lhs_subtree_root->left_and_balance = rhs_subtree_root->left_and_balance & BALANCE_MASK; // same balance, no left child yet
     lhs_subtree_root->right = nullptr;
-    lhs_subtree_root->left = nullptr;
     if(rhs_subtree_root->right != nullptr){
       lhs_subtree_root->right = new Node;
       node_count++;
     }
-    if(rhs_subtree_root->left != nullptr){
-      lhs_subtree_root->left = new Node;
+    if(left_of(rhs_subtree_root) != nullptr){
+      set_left(lhs_subtree_root, new Node);
       node_count++;
     }
-    if(rhs_subtree_root->left != nullptr){
-    copy(lhs_subtree_root->left, rhs_subtree_root->left); // traverse left on rhs
+    if(left_of(rhs_subtree_root) != nullptr){
+    copy(left_of(lhs_subtree_root), left_of(rhs_subtree_root)); // traverse left on rhs
     }
     if(rhs_subtree_root->right != nullptr){
     copy(lhs_subtree_root->right, rhs_subtree_root->right); // traverse right on rhs
@@ -316,153 +405,6 @@ void AVLCollection<K,V>::copy (Node* lhs_subtree_root, const Node* rhs_subtree_r
 };
 
 
-template<typename K, typename V>
-typename AVLCollection<K,V>::Node*
-AVLCollection<K,V>::updateheight(Node* subtree_root){ // helper funtion for removal to make sure heights are correct before rebalancing
-  if(subtree_root == nullptr){
-    return nullptr;
-  }
-  subtree_root->left = updateheight(subtree_root->left);
-  subtree_root->right = updateheight(subtree_root->right);
-  // backtracking: update heights
-  if(subtree_root->left != nullptr && subtree_root->right != nullptr){ // if it has 2 children
-          if( subtree_root->left->height >= subtree_root->right->height){
-            subtree_root->height = subtree_root->left->height +1;
-          }
-          else{
-            subtree_root->height = subtree_root->right->height +1;
-          }
-  }
-  if(subtree_root->right != nullptr && subtree_root->left == nullptr){ // one right child
-    subtree_root->height = subtree_root->right->height +1;
-  }
-  else if(subtree_root->left != nullptr && subtree_root->right == nullptr){ // one left child
-  subtree_root->height = subtree_root->left->height +1;
-  }
-  else if(subtree_root->left == nullptr && subtree_root->right == nullptr){ // no children
-    subtree_root->height = 1;
-  }
-
-  return subtree_root;
-
-}
-
-template<typename K, typename V>
-typename AVLCollection<K,V>::Node*
-AVLCollection<K,V>::remove(Node* subtree_root, const K& a_key){
-if(size() >0){
-  if(subtree_root != nullptr && subtree_root->key > a_key){ // if greater than go left
-    subtree_root->left = remove(subtree_root->left, a_key);
-  }
-  else if(subtree_root != nullptr && subtree_root->key < a_key){ // if less than go right
-    subtree_root->right = remove(subtree_root->right, a_key);
-  }
-  else if(subtree_root != nullptr && subtree_root->key == a_key){ // here we have found deletion recurrsively
-    Node* curr =nullptr;
-    // curr = subtree_root->right; // i could not get thsi code to work and update the heights reccursively while deleting
-    // if (curr != nullptr ){
-    //   if(curr->left == nullptr){ //we are in the special case
-    //     //subtree_root->right = curr->right; //skipping over right node
-    //     subtree_root->value = curr->value;// copying values and keys
-    //     subtree_root->key = curr->key;
-    //     remove(subtree_root->right,curr->key);
-    //     node_count--;
-    //     return subtree_root;
-    //     }
-    //   else{
-    //     while(curr->left != nullptr){ // finding in-order successor
-    //       //prev = curr;
-    //       curr = curr->left;
-    //     }
-    //     subtree_root->value = curr->value;//copying values
-    //     subtree_root->key = curr->key;
-    //         //prev->left = curr->right;
-    //         //delete curr;
-    //     remove(subtree_root->right,curr->key);
-    //     node_count--;
-    //     return subtree_root;
-    //   }
-    // }
-    // curr = nullptr;
-    Node* prev = nullptr;
-    if(subtree_root->left == nullptr){
-      if(subtree_root->right == nullptr){ // no children case: leaf node
-        if(root == subtree_root){
-          root = nullptr;
-        }
-
-        delete subtree_root;
-        node_count--;
-        return nullptr;
-      }
-      else{// one right child case 
-        if(root == subtree_root){
-          root = subtree_root->right;
-        }
-        curr = subtree_root->right;
-        delete subtree_root;
-        node_count--;
-        return curr;
-      }
-    }
-    else{
-      if(subtree_root->right == nullptr){ // one leftchild case
-        if(root == subtree_root){
-          root = subtree_root->left;
-        }
-        curr = subtree_root->left;
-        delete subtree_root;
-        node_count--;
-        return curr;
-      }
-      else{// two children case
-        curr = subtree_root;
-        curr = curr->right;
-        if(curr->left == nullptr){ //we are in the special case
-          subtree_root->right = curr->right; //skipping over right node
-          subtree_root->value = curr->value;// copying values and keys
-          subtree_root->key = curr->key;
-          delete curr; //delete or return
-          node_count--;
-        }
-        else{
-          while(curr->left != nullptr){ // finding in-order successor
-            prev = curr;
-            curr = curr->left;
-          }
-          subtree_root->value = curr->value;
-          subtree_root->key = curr->key;
-          prev->left = curr->right;
-          delete curr;
-          node_count--;
-        }
-
-      }
-    }
-  }
-  // back tracking update heights, could not get to work while deleting heights
-  // if(subtree_root->left != nullptr && subtree_root->right != nullptr){ // if it has 2 children
-  //         if( subtree_root->left->height >= subtree_root->right->height){
-  //           subtree_root->height = subtree_root->left->height +1;
-  //         }
-  //         else{
-  //           subtree_root->height = subtree_root->right->height +1;
-  //         }
-  // }
-  // if(subtree_root->right != nullptr && subtree_root->left == nullptr){ // one right child
-  //   subtree_root->height = subtree_root->right->height +1;
-  // }
-  // else if(subtree_root->left != nullptr && subtree_root->right == nullptr){ // one left child
-  // subtree_root->height = subtree_root->left->height +1;
-  // }
-  // else if(subtree_root->left == nullptr && subtree_root->right == nullptr){ // no children
-  //   subtree_root->height = 1;
-  // }
-
-  }
-  return subtree_root;
-};
-
 template<typename K, typename V>
 void AVLCollection<K,V>::find(const Node* subtree_root, const K& k1, const K& k2, ArrayList<K>& keys)const{
   if(subtree_root == nullptr){ // if at nullptr return
@@ -472,11 +414,11 @@ void AVLCollection<K,V>::find(const Node* subtree_root, const K& k1, const K& k2
     find(subtree_root->right,k1,k2,keys);
   }
   else if(subtree_root->key > k2){ // if current key is less than range go left
-    find(subtree_root->left,k1,k2,keys);
+    find(left_of(subtree_root),k1,k2,keys);
   }
   else { // if current key is in the range add to keys and go left and right
     keys.add(subtree_root->key);
-    find(subtree_root->left,k1,k2,keys);
+    find(left_of(subtree_root),k1,k2,keys);
     find(subtree_root->right,k1,k2,keys);
   }
   return;
@@ -487,7 +429,7 @@ void AVLCollection<K,V>::keys(const Node* subtree_root, ArrayList<K>& all_keys)c
   if(subtree_root == nullptr){ //inorder traversal
     return;
   }
-  keys(subtree_root->left,all_keys);
+  keys(left_of(subtree_root),all_keys);
 
   all_keys.add(subtree_root->key);
 
@@ -497,89 +439,75 @@ void AVLCollection<K,V>::keys(const Node* subtree_root, ArrayList<K>& all_keys)c
 
 template<typename K, typename V>
 size_t AVLCollection<K,V>::height(const Node* subtree_root)const{
-  size_t h =1;
-  if(subtree_root->right != nullptr){ //checking right path
-    if(subtree_root->left != nullptr){// two paths
-      h = 1 + height(subtree_root->left);
-      h = 1 + height(subtree_root->right);
-    }
-    else{ //one path to the right
-      h = 1 + height(subtree_root->right);
-    }
+  size_t h = 0;
+  while(subtree_root != nullptr){ // the taller child is on the side the balance factor leans to
+    h++;
+    subtree_root = balance_of(subtree_root) < 0 ? left_of(subtree_root) : subtree_root->right;
   }
-  else{//one path to the left
-    if(subtree_root->left != nullptr){
-      h = 1 + height(subtree_root->left);
-    }
-    else{ // left and right are nullptr so we are at leaf node
-      return h;
-    }
-  }
-    return h;
-};
-
-
-// add recursive helper function
-template<typename K, typename V>
-typename AVLCollection<K,V>::Node*
-AVLCollection<K,V>:: add(Node* subtree_root, const K& a_key, const V& a_val){
-    if(subtree_root == nullptr){//create node if we have reached the final location
-        subtree_root = new Node;
-        subtree_root->left = nullptr;
-        subtree_root->right = nullptr;
-        subtree_root->key = a_key;
-        subtree_root->value = a_val;
-        subtree_root->height =1;
-    }
-    else{
-        if(a_key < subtree_root->key){
-            subtree_root->left = add(subtree_root->left, a_key, a_val);
-        }
-        else{
-            subtree_root->right = add(subtree_root->right, a_key, a_val); // recurrsively traverse to insertion
-        }
-        //backtracking: adjust heights
-        if(subtree_root->left != nullptr && subtree_root->right != nullptr){ // if it has 2 children
-          if( subtree_root->left->height >= subtree_root->right->height){ //compare child heights and update
-            subtree_root->height = subtree_root->left->height +1;
-          }
-          else{
-            subtree_root->height = subtree_root->right->height +1;
-          }
-        }
-        if(subtree_root->right != nullptr && subtree_root->left == nullptr){ // one right child
-          subtree_root->height = subtree_root->right->height +1;
-        }
-        else if(subtree_root->left != nullptr && subtree_root->right == nullptr){ // one left child
-          subtree_root->height = subtree_root->left->height +1;
-        }
-        else if(subtree_root->left == nullptr && subtree_root->right == nullptr){
-          subtree_root->height = 1;
-        }
-    }
-    // backtracking: rebalance at the subtreee root as needed
-    return rebalance(subtree_root);
-    //return subtree_root;
-
+  return h;
 };
 
 
 template<typename K, typename V>
 void AVLCollection<K,V>:: add(const K& a_key, const V& a_val){
-    root = add(root,a_key, a_val);
+    Node* path[MAX_PATH];
+    signed char dirs[MAX_PATH];
+    size_t depth = 0;
+    Node* itr = root;
+    while(itr != nullptr){ // walk down to the empty link the key belongs on
+        path[depth] = itr;
+        dirs[depth] = (a_key < itr->key) ? -1 : 1;
+        itr = (dirs[depth++] < 0) ? left_of(itr) : itr->right;
+    }
+    Node* ptr = new Node;
+    ptr->left_and_balance = 1; // no left child, balanced
+    ptr->right = nullptr;
+    ptr->key = a_key;
+    ptr->value = a_val;
+    set_child(depth > 0 ? path[depth - 1] : nullptr, depth > 0 ? dirs[depth - 1] : 0, ptr);
     node_count++;
+    retrace_add(path, dirs, depth); // at most one (single or double) rotation happens
 };
 
 
 template<typename K, typename V>
 void AVLCollection<K,V>:: remove(const K& a_key){
-  if((size() > 0)){ //there are keys in the table
-    remove(root,a_key);// recurresive helper to remove node
-    updateheight(root); //helper to make heights correct before rebalancing
-    root = rebalance(root); // rebalancing tree and setting to root
+  Node* path[MAX_PATH];
+  signed char dirs[MAX_PATH];
+  size_t depth = 0;
+  Node* target = root;
+  while(target != nullptr && !(target->key == a_key)){
+    path[depth] = target;
+    dirs[depth] = (target->key > a_key) ? -1 : 1;
+    target = (dirs[depth++] < 0) ? left_of(target) : target->right;
   }
+  if(target == nullptr){ // key is not in the tree
+    return;
+  }
+  if(left_of(target) != nullptr && target->right != nullptr){ // two children case
+    // the in-order successor takes target's place in the key order and
+    // has no left child, so it is the node that actually comes out
+    path[depth] = target;
+    dirs[depth++] = 1;
+    Node* succ = target->right;
+    while(left_of(succ) != nullptr){
+      path[depth] = succ;
+      dirs[depth++] = -1;
+      succ = left_of(succ);
+    }
+    target->key = succ->key;
+    target->value = succ->value;
+    target = succ;
+  }
+  // splice out the zero or one child node
+  Node* child = (left_of(target) != nullptr) ? left_of(target) : target->right;
+  set_child(depth > 0 ? path[depth - 1] : nullptr, depth > 0 ? dirs[depth - 1] : 0, child);
+  delete target;
+  node_count--;
+  retrace_remove(path, dirs, depth);
 };
 
+
 template<typename K, typename V>
 bool AVLCollection<K,V>:: find(const K& search_key, V& the_val) const{
   if(node_count > 0){
@@ -590,11 +518,11 @@ bool AVLCollection<K,V>:: find(const K& search_key, V& the_val) const{
         return true;
       }
       else if(itr->key > search_key){ //if current key is larger go left
-        if(itr->left == nullptr){ //if we cant go left
+        if(left_of(itr) == nullptr){ //if we cant go left
           return false; // it is not in the list
         }
         else{// otherwise go left
-          itr = itr-> left;
+          itr = left_of(itr);
         }
       }
       else{ // current key must be small than our key
@@ -612,20 +540,17 @@ bool AVLCollection<K,V>:: find(const K& search_key, V& the_val) const{
 
 template<typename K, typename V>
 void AVLCollection<K,V>:: find(const K& k1, const K& k2, ArrayList<K>& keys) const{ 
+    keys.clear(); // make return array empty
     if((k2 >= k1) && (size() > 0)){ // if we have a positive range and a postive size
-        while(keys.size()>0){// make return array empty
-            keys.remove(0);
-        }
           find(root, k1, k2, keys);
         }         
  };
 
 template<typename K, typename V>
 void AVLCollection<K,V>:: keys(ArrayList<K>& all_keys) const{
+all_keys.clear();
 if(size() > 0){
-    while(all_keys.size()>0){
-        all_keys.remove(0);
-    }
+    all_keys.reserve(size());
     keys(root, all_keys);
   }
  };
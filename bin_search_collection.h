@@ -7,6 +7,19 @@
 //       collection is kept in sorted order all times. Binary search is
 //       give the positon of the element or the position of where the
 //       the element should go along with returning true and false.
+//       Keys and values are kept in separate (parallel) lists so that
+//       searches and key scans never pull values into the cache.
+//       freeze() adds a read-only copy of the keys in Eytzinger (BFS)
+//       order, each with the index of its value, for cache friendly
+//       lookups; any add or remove drops it again.
+//       An optional insert buffer (a red-black tree) takes new pairs
+//       in O(log n) and is merged into the sorted list in one linear
+//       pass once it holds more than n/log2(n) pairs, so building the
+//       collection no longer shifts the list on every add.
+//       learn() fits a piecewise-linear model over arithmetic keys
+//       (a learned index): each segment predicts a key's index to
+//       within MODEL_ERROR, so a find searches a small window instead
+//       of the whole list. Changes to the sorted list drop the model.
 //----------------------------------------------------------------------
 
 
@@ -15,6 +28,19 @@
 
 #include "array_list.h"
 #include "collection.h"
+#include "rbt_collection.h"
+#include <type_traits>
+#include <cstdint>
+
+// learned index models only fit keys that convert to numbers
+struct learned_index_tag {};
+struct no_learned_index_tag {};
+
+template<typename T, bool = std::is_arithmetic<T>::value>
+struct learned_index_category { typedef no_learned_index_tag type; };
+
+template<typename T>
+struct learned_index_category<T,true> { typedef learned_index_tag type; };
 
 template<typename K, typename V>
 class BinSearchCollection : public Collection<K,V>
@@ -23,6 +49,10 @@ public:
   // add a new key-value pair into the collection 
     void add(const K& a_key, const V& a_val);
 
+  // add n new key-value pairs at once: the batch is sorted and merged
+  // into the list in one pass instead of shifting the tail per pair
+    void add(const std::pair<K,V>* pairs, size_t n);
+
   // remove a key-value pair from the collection
     void remove(const K& a_key);
 
@@ -32,6 +62,10 @@ public:
 
   // find and return each key >= k1 and <= k2 
     void find(const K& k1, const K& k2, ArrayList<K>& keys) const;
+
+  // number of keys >= k1 and <= k2, from two searches without copying
+  // any keys (buffered keys are counted by walking the buffer's range)
+    size_t count_range(const K& k1, const K& k2) const;
   
   // return all of the keys in the collection 
     void keys(ArrayList<K>& all_keys) const;
@@ -42,138 +76,564 @@ public:
   // return the number of key-value pairs in the collection
     size_t size() const;
 
+  // lay the keys out in Eytzinger order for faster finds; the next add
+  // or remove thaws the collection again. This costs a second copy of
+  // the keys plus 4 bytes per pair (values are not copied), and lists
+  // of 2^32 or more pairs are left unfrozen
+    void freeze();
+
+  // true between freeze() and the next add or remove
+    bool is_frozen() const;
+
+  // turn the insert buffer on or off; turning it off (or freezing)
+  // merges whatever is buffered into the list first
+    void set_insert_buffer(bool enable);
+
+  // true if adds go through the insert buffer
+    bool has_insert_buffer() const;
+
+  // fit the learned index model over the sorted keys; returns false
+  // (and finds keep using binary search) if the keys aren't arithmetic.
+  // Buffered adds keep the model, anything that changes the sorted
+  // list drops it
+    bool learn();
+
+  // true between learn() and the next change to the sorted list
+    bool is_learned() const;
+
+  // number of linear segments in the model (0 if there is none)
+    size_t learned_segments() const;
+
 private:
-  ArrayList<std::pair<K,V>> kv_list;
+  // the sorted keys and, at the same indexes, their values
+  ArrayList<K> key_list;
+  ArrayList<V> val_list;
+
+  // pairs added since the last merge (insert buffer mode only)
+  RBTCollection<K,V> buffer;
+  bool buffered = false;
+
+    // smallest buffer size worth merging for
+    static const size_t MIN_BUFFER = 64;
+
+  // frozen copy: slot k (from 1) holds a node whose children are 2k and
+  // 2k+1, and eytz_ranks[k] is the node's index in the sorted lists (so
+  // its value is val_list[eytz_ranks[k]]); slot 0 is unused. The keys
+  // start eytz_offset slots in so slot 0 sits on a cache line boundary,
+  // which keeps the 16 descendants four levels down in one line for
+  // small keys
+  ArrayList<K> eytz_keys;
+  ArrayList<uint32_t> eytz_ranks;
+  size_t eytz_offset = 0;
+  bool frozen = false;
+
+    // Eytzinger levels to prefetch ahead of the search (2^4 = 16 slots)
+    static const size_t PREFETCH_LEVELS = 4;
+
+  // learned index model: segment s covers the sorted keys from
+  // model_starts[s] up to the next segment's start and predicts key k
+  // at model_starts[s] + model_slopes[s]*(k - model_keys[s])
+  ArrayList<K> model_keys;
+  ArrayList<double> model_slopes;
+  ArrayList<size_t> model_starts;
+  bool learned = false;
+
+    // most slots a prediction may be off by for a key in the list
+    static const size_t MODEL_ERROR = 16;
 
-    //binary search helper function
-    bool bin_search(const K& key, size_t& index)const;
+    // fit the segments in one pass (shrinking cone: a segment grows
+    // while some slope keeps every key in it within MODEL_ERROR)
+    bool learn(learned_index_tag);
+    bool learn(no_learned_index_tag);
+
+    // lower_bound through the model: binary search over the segment
+    // start keys, then over the window around the prediction
+    size_t learned_lower_bound(const K& key, learned_index_tag) const;
+    size_t learned_lower_bound(const K& key, no_learned_index_tag) const;
+
+    // drop the model
+    void unlearn();
+
+    // fills slot k's subtree from the sorted lists starting at index i, returns
+    // the next unused index
+    size_t eytzinger_fill(size_t i, size_t k);
+
+    // drop the frozen copy
+    void thaw();
+
+    // merge the insert buffer into the sorted lists and empty it
+    void flush();
+
+    // sorted merge of two ascending key lists into out
+    static void merge_keys(const ArrayList<K>& a, const ArrayList<K>& b, ArrayList<K>& out);
+
+    // orders a batch of pairs by key alone
+    struct ByKey{
+        std::pair<K,V> kv;
+        bool operator<(const ByKey& rhs) const {return kv.first < rhs.kv.first;}
+    };
+
+    // merges n pairs, already in key order, into the sorted lists in
+    // one pass
+    void merge_pairs(const ByKey* sorted, size_t n);
+
+    // index of the first key that is not less than key (the number of
+    // sorted keys if there is none), comparing keys in place
+    size_t lower_bound(const K& key) const;
+
+    // the same, searching only the keys at [lo, hi) (hi if there is none)
+    size_t lower_bound(const K& key, size_t lo, size_t hi) const;
+
+    // index of the first key that is greater than key (the number of
+    // sorted keys if there is none)
+    size_t upper_bound(const K& key) const;
 };
 
 template<typename K, typename V>
- bool BinSearchCollection<K,V>:: bin_search(const K& key, size_t& index)const{
-     size_t center = kv_list.size()/2; // finds center of the list
-     size_t l = 0; // sets left to 0
-     size_t r = kv_list.size(); // sets right to the last element in the list
-     int count = 0; // count used to determine when we hav reached the end of the list and the k has not been found
-     std::pair<K,V> temp;
-for(;;) {
-    kv_list.get(center, temp); 
-    if (temp.first== key){ // if center is the key we are done 
-        index = center;
-        return true;
-    }
-    else if (temp.first > key) { // if the key is less that center search the left half of the list because it is sorter
-        r = center; 
-        center = (l+r)/2;
-    }
-    else { // else serach the right side of the list b/c is must be greater than the center
-        l = center;
-        center = (l+r)/2;
-    }
-
-    if((center == l) or (center == r)){ // if ceneter is equal to left or right we know we are down the 2 elements
-        count++;
-    }
-    else{ // be left and right consecutivelye
-        count = 0;
-    }
-
-    if(count ==2){ // if we search left and right consecutively we know we have searched everything and the element is not in the list
-        if(center == l){//if center is left then the element is bigger than center, which is r
-            index = r;
-        }
-        else if(center == r){ //if center is right then the element is smaller than center, which is l
-            index = l;
-        }
-        return false; // we know we have searched the whole list and the item is not in the list so return false
-    }
-}
+ size_t BinSearchCollection<K,V>:: lower_bound(const K& key) const{
+   return lower_bound(key, 0, key_list.size());
+ };
 
-};
+template<typename K, typename V>
+ size_t BinSearchCollection<K,V>:: lower_bound(const K& key, size_t lo, size_t hi) const{
+   const K* first = key_list.data();
+   const K* base = first + lo;
+   size_t n = hi - lo;
+   if(n == 0){
+     return lo;
+   }
+   while(n > 1){ // the answer is always in [base, base + n]
+     size_t half = n/2;
+     size_t next = (n - half)/2;
+     __builtin_prefetch(base + next); // both places the next probe can land
+     __builtin_prefetch(base + half + next);
+     base = (base[half] < key) ? base + half : base; // a conditional move, not a branch
+     n -= half;
+   }
+   return (base - first) + (*base < key);
+ };
 
+template<typename K, typename V>
+ size_t BinSearchCollection<K,V>:: upper_bound(const K& key) const{
+   const K* first = key_list.data();
+   const K* base = first;
+   size_t n = key_list.size();
+   if(n == 0){
+     return 0;
+   }
+   while(n > 1){ // same search as lower_bound, but equal keys go left
+     size_t half = n/2;
+     size_t next = (n - half)/2;
+     __builtin_prefetch(base + next);
+     __builtin_prefetch(base + half + next);
+     base = (key < base[half]) ? base : base + half;
+     n -= half;
+   }
+   return (base - first) + !(key < *base);
+ };
+
+template<typename K, typename V>
+ void BinSearchCollection<K,V>:: freeze(){
+   flush();
+   const size_t LINE = 64;
+   size_t n = key_list.size();
+   if(n >= UINT32_MAX){ // ranks would not fit
+     thaw();
+     return;
+   }
+   size_t pad = (LINE % sizeof(K) == 0) ? LINE/sizeof(K) : 0;
+   eytz_keys.clear();
+   eytz_ranks.clear();
+   eytz_keys.reserve(n + 1 + pad);
+   eytz_ranks.reserve(n + 1);
+   size_t misalign = reinterpret_cast<size_t>(eytz_keys.data()) % LINE;
+   eytz_offset = (pad > 0 && misalign % sizeof(K) == 0) ? ((LINE - misalign) % LINE)/sizeof(K) : 0;
+   for(size_t k = 0; k<=n + eytz_offset; k++){ // slots are filled out of order below
+     eytz_keys.add(K());
+   }
+   for(size_t k = 0; k<=n; k++){
+     eytz_ranks.add(0);
+   }
+   eytzinger_fill(0, 1);
+   frozen = true;
+ };
+
+template<typename K, typename V>
+ size_t BinSearchCollection<K,V>:: eytzinger_fill(size_t i, size_t k){
+   if(k < eytz_ranks.size()){ // an in-order walk of the implicit tree
+     i = eytzinger_fill(i, 2*k);
+     eytz_keys.data()[eytz_offset + k] = key_list.data()[i];
+     eytz_ranks.data()[k] = (uint32_t)i;
+     i = eytzinger_fill(i + 1, 2*k + 1);
+   }
+   return i;
+ };
+
+template<typename K, typename V>
+ void BinSearchCollection<K,V>:: thaw(){
+   if(frozen){
+     eytz_keys.clear();
+     eytz_keys.shrink_to_fit();
+     eytz_ranks.clear();
+     eytz_ranks.shrink_to_fit();
+     frozen = false;
+   }
+ };
+
+template<typename K, typename V>
+ bool BinSearchCollection<K,V>:: is_frozen() const{
+   return frozen;
+ };
+
+template<typename K, typename V>
+ bool BinSearchCollection<K,V>:: learn(){
+   return learn(typename learned_index_category<K>::type());
+ };
+
+template<typename K, typename V>
+ bool BinSearchCollection<K,V>:: learn(no_learned_index_tag){
+   return false;
+ };
+
+template<typename K, typename V>
+ bool BinSearchCollection<K,V>:: learn(learned_index_tag){
+   unlearn();
+   const K* ks = key_list.data();
+   size_t n = key_list.size();
+   const double err = (double)MODEL_ERROR;
+   size_t start = 0;
+   while(start < n){
+     // slopes from the first key that keep every later key within err
+     double x0 = (double)ks[start];
+     double low = 0.0;
+     double high = 1e300;
+     size_t i = start + 1;
+     for(; i<n; i++){
+       double dx = (double)ks[i] - x0;
+       double dy = (double)(i - start);
+       if(dx <= 0.0){ // keys too close to tell apart as doubles
+         break;
+       }
+       double slope = dy/dx;
+       if(slope < low || slope > high){ // the cone closed, start a new segment here
+         break;
+       }
+       double lo_slope = (dy - err)/dx;
+       double hi_slope = (dy + err)/dx;
+       low = (lo_slope > low) ? lo_slope : low;
+       high = (hi_slope < high) ? hi_slope : high;
+     }
+     model_keys.add(ks[start]);
+     model_slopes.add((i == start + 1) ? 0.0 : (low + high)/2);
+     model_starts.add(start);
+     start = i;
+   }
+   learned = true;
+   return true;
+ };
+
+template<typename K, typename V>
+ size_t BinSearchCollection<K,V>:: learned_lower_bound(const K& key, no_learned_index_tag) const{
+   return lower_bound(key);
+ };
+
+template<typename K, typename V>
+ size_t BinSearchCollection<K,V>:: learned_lower_bound(const K& key, learned_index_tag) const{
+   size_t n = key_list.size();
+   if(n == 0 || !(model_keys.data()[0] < key)){
+     return 0;
+   }
+   // last segment starting below key: a run of equal keys can span two
+   // segments, and its first copy is in the earlier one
+   const K* firsts = model_keys.data();
+   size_t lo = 0, hi = model_keys.size();
+   while(hi - lo > 1){
+     size_t mid = (lo + hi)/2;
+     if(firsts[mid] < key){
+       lo = mid;
+     }
+     else{
+       hi = mid;
+     }
+   }
+   size_t start = model_starts.data()[lo];
+   size_t end = (lo + 1 < model_starts.size()) ? model_starts.data()[lo + 1] : n;
+   double guess = (double)start + model_slopes.data()[lo]*((double)key - (double)firsts[lo]);
+   if(guess > (double)end){ // keys past the segment's last one
+     guess = (double)end;
+   }
+   // every key of the segment is within MODEL_ERROR of its prediction,
+   // so one more slot on each side also covers keys that fall between two
+   size_t reach = MODEL_ERROR + 1;
+   size_t first = start;
+   size_t last = end;
+   if(guess - (double)start > (double)reach){
+     first = start + (size_t)(guess - (double)start) - reach;
+   }
+   if(guess + (double)reach < (double)end){
+     last = (size_t)guess + reach + 1;
+   }
+   if(first > last){
+     first = last;
+   }
+   const K* ks = key_list.data();
+   // rounding can only move a prediction further than promised for keys
+   // too large for a double to hold exactly, so check before trusting it
+   if((first > start && !(ks[first - 1] < key)) || (last < end && ks[last] < key)){
+     return lower_bound(key, start, end);
+   }
+   return lower_bound(key, first, last);
+ };
+
+template<typename K, typename V>
+ void BinSearchCollection<K,V>:: unlearn(){
+   if(learned){
+     model_keys.clear();
+     model_slopes.clear();
+     model_starts.clear();
+     learned = false;
+   }
+ };
+
+template<typename K, typename V>
+ bool BinSearchCollection<K,V>:: is_learned() const{
+   return learned;
+ };
+
+template<typename K, typename V>
+ size_t BinSearchCollection<K,V>:: learned_segments() const{
+   return model_keys.size();
+ };
+
+template<typename K, typename V>
+ void BinSearchCollection<K,V>:: set_insert_buffer(bool enable){
+   if(!enable){
+     flush();
+   }
+   buffered = enable;
+ };
+
+template<typename K, typename V>
+ bool BinSearchCollection<K,V>:: has_insert_buffer() const{
+   return buffered;
+ };
+
+template<typename K, typename V>
+ void BinSearchCollection<K,V>:: flush(){
+   size_t n = buffer.size();
+   if(n == 0){
+     return;
+   }
+   ArrayList<K> sorted_keys;
+   buffer.sort(sorted_keys);
+   ArrayList<ByKey> batch;
+   batch.reserve(n);
+   for(size_t i = 0; i<n; i++){ // the tree hands back keys in order, values by lookup
+     ByKey b;
+     b.kv.first = sorted_keys.data()[i];
+     buffer.find(b.kv.first, b.kv.second);
+     batch.add(b);
+   }
+   buffer = RBTCollection<K,V>();
+   merge_pairs(batch.data(), n);
+ };
+
+template<typename K, typename V>
+ void BinSearchCollection<K,V>:: merge_keys(const ArrayList<K>& a, const ArrayList<K>& b, ArrayList<K>& out){
+   out.clear();
+   out.reserve(a.size() + b.size());
+   const K* x = a.data();
+   const K* y = b.data();
+   size_t i = 0, j = 0;
+   while(i < a.size() && j < b.size()){
+     if(y[j] < x[i]){
+       out.add(y[j++]);
+     }
+     else{
+       out.add(x[i++]);
+     }
+   }
+   out.append(x + i, a.size() - i);
+   out.append(y + j, b.size() - j);
+ };
 
 template<typename K, typename V>
  void BinSearchCollection<K,V>:: add(const K& a_key, const V& a_val){
-   std::pair<K,V> a;
-   a = std::make_pair(a_key, a_val);
-   if(size() == 0){
-   kv_list.add(a); //adds item toe end if the list is empty
+   thaw();
+   if(buffered){
+     buffer.add(a_key, a_val);
+     size_t n = key_list.size();
+     size_t log_n = (n > 1) ? 64 - __builtin_clzll(n) : 1;
+     // merging costs O(n), so waiting for n/log2(n) adds keeps each add
+     // at O(log n) amortized
+     size_t limit = n/log_n;
+     if(limit < MIN_BUFFER){
+       limit = MIN_BUFFER;
+     }
+     if(buffer.size() > limit){
+       flush();
+     }
+     return;
+   }
+   unlearn();
+   // lower_bound gives the exact spot that keeps the lists sorted (possibly the end)
+   size_t index = lower_bound(a_key);
+   key_list.insert(index, &a_key, 1);
+   val_list.insert(index, &a_val, 1);
+ };
+
+template<typename K, typename V>
+ void BinSearchCollection<K,V>:: add(const std::pair<K,V>* pairs, size_t n){
+   if(n == 0){
+     return;
+   }
+   thaw();
+   flush();
+   ArrayList<ByKey> batch;
+   batch.reserve(n);
+   for(size_t i = 0; i<n; i++){
+     ByKey b = {pairs[i]};
+     batch.add(b);
+   }
+   batch.sort();
+   merge_pairs(batch.data(), n);
+ };
+
+template<typename K, typename V>
+ void BinSearchCollection<K,V>:: merge_pairs(const ByKey* sorted, size_t n){
+   unlearn();
+   size_t i = key_list.size(); // old pairs still to place
+   size_t j = n; // batch pairs still to place
+   key_list.reserve(i + n);
+   val_list.reserve(i + n);
+   for(size_t b = 0; b<n; b++){ // grows once, these slots are overwritten below
+     key_list.add(sorted[b].kv.first);
+     val_list.add(sorted[b].kv.second);
    }
-   else{
-       size_t index;
-       bin_search(a_key,index); // bin search finds location to add item
-       kv_list.add(index, a); //adds items at the index found by binsearch to keep the list in sorted order
+   K* ks = key_list.data();
+   V* vs = val_list.data();
+   size_t k = i + n;
+   while(j > 0){ // merge from the back so nothing is overwritten early
+     if(i > 0 && sorted[j-1].kv.first < ks[i-1]){
+       --i;
+       --k;
+       ks[k] = std::move(ks[i]);
+       vs[k] = std::move(vs[i]);
+     }
+     else{
+       --j;
+       --k;
+       ks[k] = sorted[j].kv.first;
+       vs[k] = sorted[j].kv.second;
+     }
    }
  };
 
  template<typename K, typename V>
  void BinSearchCollection<K,V>:: remove(const K& a_key){
-   if((size() > 0)){
-     size_t index;
-    if(bin_search(a_key,index)){ //if binsearch finds the value remove that item
-        kv_list.remove(index);
-     }
+   thaw();
+   V val;
+   if(buffer.size() > 0 && buffer.find(a_key, val)){ // newer pairs live in the buffer
+     buffer.remove(a_key);
+     return;
+   }
+   size_t index = lower_bound(a_key);
+   if(index < key_list.size() && key_list.data()[index] == a_key){ //if the key is there remove that item
+     unlearn();
+     key_list.remove(index);
+     val_list.remove(index);
    }
  };
 
  template<typename K, typename V>
  bool BinSearchCollection<K,V>:: find(const K& search_key, V& the_val) const{
-   if((size() > 0)){
-    size_t index;
-    if(bin_search(search_key,index)){ // if binsearch finds the item get the value from that key
-        std::pair<K,V> temp;
-        kv_list.get(index,temp);
-        the_val= temp.second;
-        return true;
-    }
+   if(frozen){
+     const K* keys = eytz_keys.data() + eytz_offset;
+     size_t n = eytz_ranks.size();
+     size_t k = 1;
+     while(k < n){ // go right while the node is smaller than the key
+       __builtin_prefetch(keys + (k << PREFETCH_LEVELS)); // a few levels down
+       k = 2*k + (keys[k] < search_key);
+     }
+     // undo the trailing right turns and one left turn to reach the
+     // first node not smaller than the key
+     k >>= __builtin_ffsll(~k);
+     if(k != 0 && keys[k] == search_key){
+       the_val = val_list.data()[eytz_ranks.data()[k]];
+       return true;
+     }
+     return false;
+   }
+   if(buffer.size() > 0 && buffer.find(search_key, the_val)){
+     return true;
+   }
+   size_t index = learned ? learned_lower_bound(search_key, typename learned_index_category<K>::type()) : lower_bound(search_key);
+   if(index < key_list.size() && key_list.data()[index] == search_key){ // only now touch the values
+     the_val = val_list.data()[index];
+     return true;
    }
-     return false; // if not found return false
+   return false; // if not found return false
  };
 
  template<typename K, typename V>
  void BinSearchCollection<K,V>:: find(const K& k1, const K& k2, ArrayList<K>& keys) const{ 
-   if((k2 >= k1) && (size() > 0)){
-     while(keys.size()>0){
-       keys.remove(0);
-      } size_t index;
-      bin_search(k1,index); // using binsearch to find the location of the first key or where it should be
-     for(int i = index; i<kv_list.size(); i++){ // putting all values greater than the first key into the return list
-       std::pair<K,V> a;
-         kv_list.get(i,a);
-       if((a.first >= k1) && (a.first <= k2)){ //putting in all keys in the range, all in sorted order
-         keys.add(a.first);
-       }
+   keys.clear();
+   if(k2 >= k1){
+     // keys are sorted, so the range is [lower_bound(k1), upper_bound(k2))
+     // and is copied in one block without any key compares
+     size_t first = lower_bound(k1);
+     size_t last = upper_bound(k2);
+     keys.append(key_list.data() + first, last - first);
+     if(buffer.size() > 0){ // fold in the buffered keys, keeping the order
+       ArrayList<K> main_keys(std::move(keys)), buffer_keys;
+       buffer.find(k1, k2, buffer_keys);
+       merge_keys(main_keys, buffer_keys, keys);
      }
    }
  };
 
+template<typename K, typename V>
+ size_t BinSearchCollection<K,V>:: count_range(const K& k1, const K& k2) const{
+   if(k2 < k1){
+     return 0;
+   }
+   size_t count = upper_bound(k2) - lower_bound(k1);
+   if(buffer.size() > 0){
+     ArrayList<K> buffer_keys;
+     buffer.find(k1, k2, buffer_keys);
+     count += buffer_keys.size();
+   }
+   return count;
+ };
+
 template<typename K, typename V>
  void BinSearchCollection<K,V>:: keys(ArrayList<K>& all_keys) const{
+     all_keys.clear();
      if((size() > 0)){
-       while(all_keys.size()>0){
-       all_keys.remove(0);
-      }
-     for(int i = 0; i<kv_list.size(); i++){ // putting all keys into the return list, all sorted
-       std::pair<K,V> a;
-         kv_list.get(i,a);
-        all_keys.add(a.first);
+       all_keys.reserve(size());
+     all_keys.append(key_list.data(), key_list.size()); // putting all keys into the return list, all sorted
+     if(buffer.size() > 0){ // buffered keys go on the end
+       ArrayList<K> buffer_keys;
+       buffer.keys(buffer_keys);
+       all_keys.append(buffer_keys.data(), buffer_keys.size());
      }
    }
  };
 
  template<typename K, typename V>
  void BinSearchCollection<K,V>:: sort(ArrayList<K>& all_keys_sorted) const{ 
-    if((size() > 0)){
-      while(all_keys_sorted.size()>0){
-       all_keys_sorted.remove(0);
-      }
-     keys(all_keys_sorted); // all keys are alredy in sorted order
-   }
+     if(buffer.size() == 0){
+       keys(all_keys_sorted); // all keys are alredy in sorted order
+       return;
+     }
+     ArrayList<K> buffer_keys;
+     buffer.sort(buffer_keys);
+     merge_keys(key_list, buffer_keys, all_keys_sorted);
  };
 
  template<typename K, typename V>
  size_t BinSearchCollection<K,V>:: size() const{
-     return kv_list.size();
+     return key_list.size() + buffer.size();
  };
 
 
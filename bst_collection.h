@@ -397,20 +397,17 @@ bool BSTCollection<K,V>:: find(const K& search_key, V& the_val) const{
 
 template<typename K, typename V>
 void BSTCollection<K,V>:: find(const K& k1, const K& k2, ArrayList<K>& keys) const{ 
+    keys.clear(); // make return array empty
     if((k2 >= k1) && (size() > 0)){ // if we have a positive range and a postive size
-        while(keys.size()>0){// make return array empty
-            keys.remove(0);
-        }
           find(root, k1, k2, keys);
         }         
  };
 
 template<typename K, typename V>
 void BSTCollection<K,V>:: keys(ArrayList<K>& all_keys) const{
+all_keys.clear();
 if(size() > 0){
-    while(all_keys.size()>0){
-        all_keys.remove(0);
-    }
+    all_keys.reserve(size());
     keys(root, all_keys);
   }
  };
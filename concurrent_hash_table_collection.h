@@ -0,0 +1,364 @@
+//----------------------------------------------------------------------
+// FILE: concurrent_hash_table_collection
+// NAME: Scott Tornquist
+// DATE: 10/19/2026
+// DESC: Implements a thread-safe hash table version of the collection
+//       class. Buckets are guarded by a fixed set of striped locks
+//       (bucket i belongs to stripe i % STRIPES) instead of one lock
+//       for the whole table, so threads working on different stripes
+//       never wait on each other. Resizing swaps in the larger table
+//       in O(1) while holding every stripe and then migrates the old
+//       chains one stripe at a time; any thread that touches a stripe
+//       that has not been migrated yet moves it over first.
+//----------------------------------------------------------------------
+
+
+#ifndef CONCURRENT_HASH_TABLE_COLLECTION_H
+#define CONCURRENT_HASH_TABLE_COLLECTION_H
+
+#include "array_list.h"
+#include "collection.h"
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <stdlib.h>
+
+template<typename K, typename V>
+class ConcurrentHashTableCollection : public Collection<K,V>
+{
+public:
+  // add a new key-value pair into the collection
+    void add(const K& a_key, const V& a_val);
+
+  // remove a key-value pair from the collection
+    void remove(const K& a_key);
+
+  // find and return the value associated with the key
+  // if key isn't found, returns false, otherwise true
+    bool find(const K& search_key, V& the_val) const;
+
+  // find and return each key >= k1 and <= k2
+  // (each stripe is visited under its own lock, so the result is
+  // only a consistent snapshot if no writers are running)
+    void find(const K& k1, const K& k2, ArrayList<K>& keys) const;
+
+  // return all of the keys in the collection
+    void keys(ArrayList<K>& all_keys) const;
+
+  // return all of the keys in ascending (sorted) order
+    void sort(ArrayList<K>& all_keys_sorted) const;
+
+  // return the number of key-value pairs in the collection
+    size_t size() const;
+
+    // constructor
+    ConcurrentHashTableCollection();
+
+    //destructor
+    ~ConcurrentHashTableCollection();
+
+    // locks cannot be copied, so neither can the table
+    ConcurrentHashTableCollection(const ConcurrentHashTableCollection<K,V>& rhs) = delete;
+    ConcurrentHashTableCollection& operator=(const ConcurrentHashTableCollection<K,V>& rhs) = delete;
+
+    // current number of buckets in the hash table
+    size_t bucket_count() const;
+
+    // number of lock stripes guarding the buckets
+    size_t stripe_count() const;
+
+    // the stripes are cache line aligned, which the global operator new
+    // does not honour before C++17, so heap tables are allocated here
+    static void* operator new(size_t bytes);
+    static void operator delete(void* ptr);
+
+
+private:
+
+    //the chain (linkedlist) nodes
+    struct Node{
+        K key;
+        V value;
+        Node* next;
+    };
+
+    // a lock and the resize generation its buckets were last migrated
+    // to, one per cache line so neighbouring stripes never share one
+    struct alignas(64) Stripe{
+        std::mutex lock;
+        size_t epoch;
+    };
+
+    // number of lock stripes, the table capacity is always a multiple
+    static const size_t STRIPES = 64;
+
+    mutable Stripe stripes[STRIPES];
+
+    // the (resizable) hash table, only swapped while holding every stripe
+    Node** hash_table;
+
+    //current number of buckets in the hash table
+    size_t table_capacity;
+
+    // table being migrated away from (nullptr when no resize is running)
+    Node** old_table;
+
+    // number of buckets in old_table
+    size_t old_capacity;
+
+    // resize generation of hash_table
+    size_t epoch;
+
+    // only one thread resizes at a time
+    std::mutex resize_lock;
+
+    // number of k-v pairs stored in the collection
+    std::atomic<size_t> length;
+
+    //current load factor of the hash table
+    double load_factor_threshold = .75;
+
+    // double the table and migrate every stripe into it
+    void resize_and_rehash();
+
+    // move stripe s from old_table into hash_table (caller holds stripe s)
+    void migrate_stripe(size_t s) const;
+
+    // delete every node in a table
+    void make_empty(Node** table, size_t capacity);
+
+};
+
+
+template<typename K, typename V>
+void* ConcurrentHashTableCollection<K,V>::operator new(size_t bytes){
+    void* ptr = nullptr;
+    if(posix_memalign(&ptr, alignof(ConcurrentHashTableCollection<K,V>), bytes) != 0){
+        throw std::bad_alloc();
+    }
+    return ptr;
+};
+
+template<typename K, typename V>
+void ConcurrentHashTableCollection<K,V>::operator delete(void* ptr){
+    free(ptr);
+};
+
+template<typename K, typename V>
+ConcurrentHashTableCollection<K,V>::ConcurrentHashTableCollection(){ //constructor
+    static_assert(sizeof(Stripe) % 64 == 0, "each stripe fills whole cache lines");
+    length = 0;
+    epoch = 0;
+    table_capacity = STRIPES;
+    hash_table = new Node*[table_capacity];
+    for(size_t i=0; i<table_capacity; i++){ // sets every pointer to null ptr to indicate empty
+        hash_table[i] = nullptr;
+    }
+    old_table = nullptr;
+    old_capacity = 0;
+    for(size_t s=0; s<STRIPES; s++){
+        stripes[s].epoch = 0;
+    }
+};
+
+    //destructor
+template<typename K, typename V>
+ConcurrentHashTableCollection<K,V>::~ConcurrentHashTableCollection(){
+    if(old_table != nullptr){
+        make_empty(old_table, old_capacity);
+        delete [] old_table;
+    }
+    make_empty(hash_table, table_capacity);
+    delete [] hash_table;
+    length = 0;
+    table_capacity = 0;
+};
+
+template<typename K, typename V>
+void ConcurrentHashTableCollection<K,V>::make_empty(Node** table, size_t capacity){
+    for(size_t i=0; i<capacity; i++){
+        Node* ptr = table[i];
+        while(ptr != nullptr){
+            Node* next = ptr->next;
+            delete ptr;
+            ptr = next;
+        }
+        table[i] = nullptr;
+    }
+};
+
+template<typename K, typename V>
+void ConcurrentHashTableCollection<K,V>::migrate_stripe(size_t s) const{
+    if(stripes[s].epoch == epoch){ // already moved into the current table
+        return;
+    }
+    // the buckets of stripe s in the old table only rehash into buckets
+    // of stripe s in the new table since STRIPES divides both capacities
+    std::hash<K> hash_fun;
+    for(size_t i=s; i<old_capacity; i+=STRIPES){
+        Node* itr = old_table[i];
+        while(itr != nullptr){ // splice each node into the new table
+            Node* next = itr->next;
+            size_t index = hash_fun(itr->key)%table_capacity;
+            itr->next = hash_table[index];
+            hash_table[index] = itr;
+            itr = next;
+        }
+        old_table[i] = nullptr;
+    }
+    stripes[s].epoch = epoch;
+};
+
+template<typename K, typename V>
+void ConcurrentHashTableCollection<K,V>::resize_and_rehash(){
+    std::unique_lock<std::mutex> guard(resize_lock, std::try_to_lock);
+    if(!guard.owns_lock()){ // another thread is already growing the table
+        return;
+    }
+    // only the resize lock holder changes the capacity, so it can read it
+    size_t newcapacity = 2*table_capacity;
+    if(length < load_factor_threshold*table_capacity){ // someone beat us to it
+        return;
+    }
+    Node** newtable = new Node*[newcapacity];
+    for(size_t i=0; i<newcapacity; i++){
+        newtable[i] = nullptr;
+    }
+    for(size_t s=0; s<STRIPES; s++){ // briefly hold every stripe to swap tables
+        stripes[s].lock.lock();
+    }
+    old_table = hash_table;
+    old_capacity = table_capacity;
+    hash_table = newtable;
+    table_capacity = newcapacity;
+    epoch++;
+    for(size_t s=STRIPES; s>0; s--){
+        stripes[s-1].lock.unlock();
+    }
+    for(size_t s=0; s<STRIPES; s++){ // then migrate one stripe at a time
+        std::lock_guard<std::mutex> stripe_guard(stripes[s].lock);
+        migrate_stripe(s);
+    }
+    // every stripe is on the new table now, so nothing reads the old one
+    delete [] old_table;
+    old_table = nullptr;
+    old_capacity = 0;
+};
+
+template<typename K, typename V>
+void ConcurrentHashTableCollection<K,V>:: add(const K& a_key, const V& a_val){
+    std::hash<K> hash_fun; // finding hash index
+    size_t code = hash_fun(a_key);
+    size_t s = code%STRIPES;
+    bool grow = false;
+    {
+        std::lock_guard<std::mutex> guard(stripes[s].lock);
+        migrate_stripe(s);
+        size_t index = code%table_capacity;
+        Node* ptr = new Node; // placing node at hash index and moving pointers
+        ptr->key = a_key;
+        ptr->value = a_val;
+        ptr->next = hash_table[index];
+        hash_table[index] = ptr;
+        grow = ++length >= load_factor_threshold*table_capacity;
+    }
+    if(grow){ // resize outside of the stripe lock
+        resize_and_rehash();
+    }
+};
+
+template<typename K, typename V>
+void ConcurrentHashTableCollection<K,V>:: remove(const K& a_key){
+    std::hash<K> hash_fun;
+    size_t code = hash_fun(a_key);
+    size_t s = code%STRIPES;
+    std::lock_guard<std::mutex> guard(stripes[s].lock);
+    migrate_stripe(s);
+    Node** link = &hash_table[code%table_capacity];
+    while(*link != nullptr){ // unlink the matching node from its chain
+        if((*link)->key == a_key){
+            Node* ptr = *link;
+            *link = ptr->next;
+            delete ptr;
+            length--;
+            return;
+        }
+        link = &(*link)->next;
+    }
+};
+
+template<typename K, typename V>
+bool ConcurrentHashTableCollection<K,V>:: find(const K& search_key, V& the_val) const{
+    std::hash<K> hash_fun;
+    size_t code = hash_fun(search_key);
+    size_t s = code%STRIPES;
+    std::lock_guard<std::mutex> guard(stripes[s].lock);
+    migrate_stripe(s);
+    Node* ptr = hash_table[code%table_capacity]; // hash to index from the key
+    while(ptr!= nullptr){ // iterate through the chain to find the value
+        if(ptr->key == search_key){
+            the_val = ptr->value;
+            return true;
+        }
+        ptr= ptr->next;
+    }
+    return false; // if not found return false
+};
+
+template<typename K, typename V>
+void ConcurrentHashTableCollection<K,V>:: find(const K& k1, const K& k2, ArrayList<K>& keys) const{
+    keys.clear();
+    if(k2 >= k1){
+        for(size_t s=0; s<STRIPES; s++){ // go through the table one stripe at a time
+            std::lock_guard<std::mutex> guard(stripes[s].lock);
+            migrate_stripe(s);
+            for(size_t i=s; i<table_capacity; i+=STRIPES){
+                for(Node* ptr = hash_table[i]; ptr!=nullptr; ptr = ptr->next){
+                    if(ptr->key >= k1 && ptr->key<= k2){// if the key is the range, add it
+                        keys.add(ptr->key);
+                    }
+                }
+            }
+        }
+    }
+};
+
+template<typename K, typename V>
+void ConcurrentHashTableCollection<K,V>:: keys(ArrayList<K>& all_keys) const{
+    all_keys.clear();
+    for(size_t s=0; s<STRIPES; s++){ // go through the table one stripe at a time
+        std::lock_guard<std::mutex> guard(stripes[s].lock);
+        migrate_stripe(s);
+        for(size_t i=s; i<table_capacity; i+=STRIPES){
+            for(Node* ptr = hash_table[i]; ptr!=nullptr; ptr = ptr->next){
+                all_keys.add(ptr->key);// add all keys
+            }
+        }
+    }
+};
+
+template<typename K, typename V>
+void ConcurrentHashTableCollection<K,V>:: sort(ArrayList<K>& all_keys_sorted) const{
+    keys(all_keys_sorted); // get all keys frome the table
+    all_keys_sorted.sort(); // sort the array with all the keys using quick sort
+};
+
+template<typename K, typename V>
+size_t ConcurrentHashTableCollection<K,V>:: size() const{
+    return length;
+};
+
+template<typename K, typename V>
+size_t ConcurrentHashTableCollection<K,V>:: bucket_count() const{
+    std::lock_guard<std::mutex> guard(stripes[0].lock);
+    return table_capacity;
+};
+
+template<typename K, typename V>
+size_t ConcurrentHashTableCollection<K,V>:: stripe_count() const{
+    return STRIPES;
+};
+
+
+#endif
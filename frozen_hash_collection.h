@@ -0,0 +1,312 @@
+//----------------------------------------------------------------------
+// FILE: frozen_hash_collection
+// NAME: Scott Tornquist
+// DATE: 10/19/2026
+// DESC: Implements a read-only hash table version of the collection
+//       class, built once from any other collection through its keys
+//       and find functions. The table is a minimal perfect hash
+//       (hash and displace): keys are split into buckets of about
+//       four, and each bucket gets a seed that sends all of its keys
+//       to slots no other key uses, so the n keys fill exactly n
+//       slots and a find looks at one slot only. Buckets of a single
+//       key store their slot directly. Keys, values and seeds live in
+//       three flat arrays that hold no pointers. add and remove do
+//       nothing; build a new table to change the contents.
+//----------------------------------------------------------------------
+
+
+#ifndef FROZEN_HASH_COLLECTION_H
+#define FROZEN_HASH_COLLECTION_H
+
+#include "array_list.h"
+#include "collection.h"
+#include <functional>
+#include <cstdint>
+
+template<typename K, typename V>
+class FrozenHashCollection : public Collection<K,V>
+{
+public:
+  // the table is read only, so add and remove leave it unchanged
+    void add(const K& a_key, const V& a_val);
+    void remove(const K& a_key);
+
+  // find and return the value associated with the key
+  // if key isn't found, returns false, otherwise true
+    bool find(const K& search_key, V& the_val) const;
+
+  // find and return each key >= k1 and <= k2
+    void find(const K& k1, const K& k2, ArrayList<K>& keys) const;
+
+  // return all of the keys in the collection
+    void keys(ArrayList<K>& all_keys) const;
+
+  // return all of the keys in ascending (sorted) order
+    void sort(ArrayList<K>& all_keys_sorted) const;
+
+  // return the number of key-value pairs in the collection
+    size_t size() const;
+
+    // empty table
+    FrozenHashCollection();
+
+    // table holding every pair of source
+    explicit FrozenHashCollection(const Collection<K,V>& source);
+
+    // replace the contents with every pair of source; returns false
+    // (leaving the table empty) if no perfect hash was found, which
+    // only happens if source has duplicate keys or keys whose hash
+    // codes are equal
+    bool build(const Collection<K,V>& source);
+
+private:
+
+    // slot i holds key_slots[i] and val_slots[i]
+    ArrayList<K> key_slots;
+    ArrayList<V> val_slots;
+
+    // one seed per bucket: a slot index if DIRECT is set, otherwise
+    // the displacement its keys were hashed with
+    ArrayList<uint32_t> seeds;
+
+    // mixed into every hash code; changed if a build attempt fails
+    uint64_t salt;
+
+    // average keys per bucket
+    static const size_t BUCKET_LOAD = 4;
+
+    // marks a seed that is the slot of a one key bucket
+    static const uint32_t DIRECT = 0x80000000u;
+
+    // seeds tried per bucket, and salts tried per build, before giving up
+    static const uint32_t MAX_SEEDS = 1u << 20;
+    static const size_t MAX_SALTS = 8;
+
+    // scrambles all bits of h (the splitmix64 finalizer)
+    static uint64_t mix(uint64_t h);
+
+    // salted hash code of key
+    uint64_t hash_code(const K& key) const;
+
+    // slot for a key with hash code h in a bucket with the given seed
+    size_t slot_of(uint64_t h, uint32_t seed) const;
+
+    // one build attempt with the current salt
+    bool place(const ArrayList<K>& all_keys, const Collection<K,V>& source);
+};
+
+template<typename K, typename V>
+FrozenHashCollection<K,V>::FrozenHashCollection(){ //constructor
+    salt = 0;
+};
+
+template<typename K, typename V>
+FrozenHashCollection<K,V>::FrozenHashCollection(const Collection<K,V>& source){
+    salt = 0;
+    build(source);
+};
+
+template<typename K, typename V>
+uint64_t FrozenHashCollection<K,V>::mix(uint64_t h){
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+};
+
+template<typename K, typename V>
+uint64_t FrozenHashCollection<K,V>::hash_code(const K& key) const{
+    std::hash<K> hash_fun;
+    return mix(hash_fun(key) ^ salt);
+};
+
+template<typename K, typename V>
+size_t FrozenHashCollection<K,V>::slot_of(uint64_t h, uint32_t seed) const{
+    if(seed & DIRECT){
+        return seed & ~DIRECT;
+    }
+    return mix(h + (seed + 1)*0x9e3779b97f4a7c15ULL) % key_slots.size();
+};
+
+template<typename K, typename V>
+bool FrozenHashCollection<K,V>::build(const Collection<K,V>& source){
+    ArrayList<K> all_keys;
+    source.keys(all_keys);
+    for(size_t attempt = 0; attempt < MAX_SALTS; attempt++){
+        salt = mix(attempt + 1);
+        if(place(all_keys, source)){
+            return true;
+        }
+    }
+    key_slots.clear();
+    val_slots.clear();
+    seeds.clear();
+    return false;
+};
+
+template<typename K, typename V>
+bool FrozenHashCollection<K,V>::place(const ArrayList<K>& all_keys, const Collection<K,V>& source){
+    size_t n = all_keys.size();
+    size_t buckets = (n + BUCKET_LOAD - 1)/BUCKET_LOAD;
+    key_slots.clear();
+    val_slots.clear();
+    seeds.clear();
+    key_slots.reserve(n);
+    val_slots.reserve(n);
+    seeds.reserve(buckets);
+    for(size_t i = 0; i<n; i++){ // slots are filled out of order below
+        key_slots.add(K());
+        val_slots.add(V());
+    }
+    for(size_t b = 0; b<buckets; b++){
+        seeds.add(0);
+    }
+    if(n == 0){
+        return true;
+    }
+    // group the keys by bucket (counting sort): bucket b's keys are
+    // members[first[b], first[b+1])
+    ArrayList<uint64_t> codes;
+    ArrayList<size_t> first;
+    ArrayList<size_t> members;
+    codes.reserve(n);
+    for(size_t i = 0; i<n; i++){
+        codes.add(hash_code(all_keys.data()[i]));
+    }
+    for(size_t b = 0; b<=buckets; b++){
+        first.add(0);
+    }
+    size_t largest = 0;
+    for(size_t i = 0; i<n; i++){
+        size_t b = codes.data()[i] % buckets;
+        first.data()[b + 1]++;
+        if(first.data()[b + 1] > largest){
+            largest = first.data()[b + 1];
+        }
+    }
+    for(size_t b = 0; b<buckets; b++){
+        first.data()[b + 1] += first.data()[b];
+    }
+    for(size_t i = 0; i<n; i++){
+        members.add(0);
+    }
+    ArrayList<size_t> next(first);
+    for(size_t i = 0; i<n; i++){
+        size_t b = codes.data()[i] % buckets;
+        members.data()[next.data()[b]++] = i;
+    }
+    // place the biggest buckets first, while most slots are free; one
+    // key buckets take whatever is left directly
+    ArrayList<char> taken;
+    for(size_t i = 0; i<n; i++){
+        taken.add(0);
+    }
+    size_t free_slot = 0;
+    ArrayList<size_t> slots;
+    for(size_t bucket_size = largest; bucket_size > 0; bucket_size--){
+        for(size_t b = 0; b<buckets; b++){
+            const size_t* keys_in = members.data() + first.data()[b];
+            if(first.data()[b + 1] - first.data()[b] != bucket_size){
+                continue;
+            }
+            if(bucket_size == 1){
+                while(taken.data()[free_slot]){
+                    free_slot++;
+                }
+                taken.data()[free_slot] = 1;
+                seeds.data()[b] = DIRECT | (uint32_t)free_slot;
+                continue;
+            }
+            uint32_t seed = 0;
+            for(; seed < MAX_SEEDS; seed++){ // until every key lands on its own free slot
+                slots.clear();
+                bool fits = true;
+                for(size_t j = 0; j<bucket_size && fits; j++){
+                    size_t s = slot_of(codes.data()[keys_in[j]], seed);
+                    if(taken.data()[s]){
+                        fits = false;
+                    }
+                    else{
+                        taken.data()[s] = 1;
+                        slots.add(s);
+                    }
+                }
+                if(fits){
+                    break;
+                }
+                for(size_t j = 0; j<slots.size(); j++){ // undo the partial placement
+                    taken.data()[slots.data()[j]] = 0;
+                }
+            }
+            if(seed == MAX_SEEDS){
+                return false;
+            }
+            seeds.data()[b] = seed;
+        }
+    }
+    for(size_t i = 0; i<n; i++){ // now copy each pair into its slot
+        const K& key = all_keys.data()[i];
+        size_t s = slot_of(codes.data()[i], seeds.data()[codes.data()[i] % buckets]);
+        key_slots.data()[s] = key;
+        source.find(key, val_slots.data()[s]);
+    }
+    return true;
+};
+
+template<typename K, typename V>
+void FrozenHashCollection<K,V>:: add(const K& /*a_key*/, const V& /*a_val*/){
+};
+
+template<typename K, typename V>
+void FrozenHashCollection<K,V>:: remove(const K& /*a_key*/){
+};
+
+template<typename K, typename V>
+bool FrozenHashCollection<K,V>:: find(const K& search_key, V& the_val) const{
+    size_t n = key_slots.size();
+    if(n == 0){
+        return false;
+    }
+    uint64_t h = hash_code(search_key);
+    size_t s = slot_of(h, seeds.data()[h % seeds.size()]);
+    if(key_slots.data()[s] == search_key){ // the only slot the key can be in
+        the_val = val_slots.data()[s];
+        return true;
+    }
+    return false; // if not found return false
+};
+
+template<typename K, typename V>
+void FrozenHashCollection<K,V>:: find(const K& k1, const K& k2, ArrayList<K>& keys) const{
+    keys.clear();
+    if(k2 >= k1){
+        const K* all = key_slots.data();
+        for(size_t i = 0; i<key_slots.size(); i++){ // slots are in hash order, check each
+            if(all[i] >= k1 && all[i] <= k2){
+                keys.add(all[i]);
+            }
+        }
+    }
+};
+
+template<typename K, typename V>
+void FrozenHashCollection<K,V>:: keys(ArrayList<K>& all_keys) const{
+    all_keys.clear();
+    all_keys.append(key_slots.data(), key_slots.size());
+};
+
+template<typename K, typename V>
+void FrozenHashCollection<K,V>:: sort(ArrayList<K>& all_keys_sorted) const{
+    keys(all_keys_sorted);
+    all_keys_sorted.sort();
+};
+
+template<typename K, typename V>
+size_t FrozenHashCollection<K,V>:: size() const{
+    return key_slots.size();
+};
+
+
+#endif
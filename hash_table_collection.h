@@ -5,7 +5,11 @@
 // DESC: Implements a hash table version of the collection
 //       class. Includes all member function inherited from collection
 //       as well as the constructor, destructor, copy constructor, and
-//       assignment operator and three public statistic functions
+//       assignment operator and three public statistic functions.
+//       An optional ordered index (a skip list of towers that point at
+//       the chain nodes) answers range and sorted queries in
+//       O(log n + k). The towers live outside the nodes, so tables
+//       without the index pay nothing for it.
 //----------------------------------------------------------------------
 
 
@@ -15,6 +19,8 @@
 #include "array_list.h"
 #include "collection.h"
 #include <functional>
+#include <thread>
+#include <new>
 
 template<typename K, typename V>
 class HashTableCollection : public Collection<K,V>
@@ -54,12 +60,26 @@ public:
     // assignment operator
     HashTableCollection& operator=(const HashTableCollection<K,V>& rhs);
 
-    //three public statistics functions
-    size_t min_chain_length();
+    //three public statistics functions, kept up to date by add,
+    //remove and rehash so reading them is O(1)
+    size_t min_chain_length() const;
+
+    size_t max_chain_length() const;
+
+    double avg_chain_length() const;
 
-    size_t max_chain_length();
+    // counts[L] = number of buckets whose chain has L nodes
+    void chain_histogram(ArrayList<size_t>& counts) const;
 
-    double avg_chain_length();
+    // current number of buckets in the hash table
+    size_t bucket_count() const;
+
+    // turn the ordered (skip list) index on or off, building it from
+    // the current pairs in O(n log n) when turned on
+    void set_ordered_index(bool enable);
+
+    // true if range and sorted queries are served by the index
+    bool has_ordered_index() const;
 
 
 private:
@@ -71,6 +91,16 @@ private:
         Node* next;
     };
 
+    // an ordered index entry for one node, allocated together with its
+    // levels skip list links, which follow it in memory (see links())
+    struct Tower{
+        Node* node;
+        size_t levels;
+    };
+
+    // tallest skip list tower, enough for 4^32 pairs
+    static const size_t MAX_LEVEL = 32;
+
     // the (resizable) hash table 
     Node** hash_table;
 
@@ -83,9 +113,86 @@ private:
     //current load factor of the hash table
     double load_factor_threshold = .75;
 
+    // number of nodes in each bucket's chain
+    size_t* chain_lengths;
+
+    // histogram[L] = number of buckets with a chain of length L
+    ArrayList<size_t> histogram;
+
+    // shortest and longest non-empty chain and number of used buckets
+    size_t min_chain;
+    size_t max_chain;
+    size_t used_buckets;
+
+    // true if the ordered index is kept up to date
+    bool ordered_index;
+
+    // skip list header (MAX_LEVEL links, no node)
+    Tower* skip_head;
+
+    // number of levels currently in use
+    size_t skip_level;
+
+    // state of the xorshift generator for tower heights
+    unsigned long skip_seed;
+
+    // nodes of the last copy live in one slab, these are released
+    // with the slab rather than one by one
+    Node* slab;
+    size_t slab_size;
+
+    // removed slab nodes (key and value reset, chained through next),
+    // reused by add before allocating new nodes
+    Node* free_nodes;
+
+    // copies at least this many pairs split the buckets across threads
+    static const size_t PARALLEL_CLONE_THRESHOLD = 1 << 16;
+    static const size_t MAX_CLONE_THREADS = 8;
+
     // double size and rehash the hash table
     void resize_and_rehash();
 
+    // delete every node, the slab and the table
+    void make_empty();
+
+    // copy rhs into this (empty) table in O(n), chains keep their order
+    void clone(const HashTableCollection<K,V>& rhs);
+
+    // copy the chains of buckets [first, last) into slab nodes from slab_pos
+    void copy_buckets(const HashTableCollection<K,V>& rhs, size_t first,
+                      size_t last, Node* slab_pos);
+
+    // true if node is one of the slab's nodes
+    bool in_slab(const Node* node) const;
+
+    // delete a node, or reset it and put it on free_nodes if it lives
+    // in the slab
+    void release_node(Node* node);
+
+    // the skip list links of a tower
+    static Tower** links(const Tower* tower);
+
+    // a tower for node with the given number of levels, links all null
+    static Tower* new_tower(Node* node, size_t levels);
+
+    // free the header and every tower in the ordered index
+    void free_towers();
+
+    // link a node into / unlink a node from the ordered index
+    void skip_insert(Node* node);
+    void skip_erase(Node* node);
+
+    // first tower in the ordered index with key >= k (or nullptr)
+    Tower* skip_lower_bound(const K& k) const;
+
+    // update the chain statistics after a node is added to or removed
+    // from the chain at index
+    void chain_grew(size_t index);
+    void chain_shrank(size_t index);
+
+    // recompute the chain statistics from chain_lengths
+    void rebuild_stats();
+
     //ArrayList<std::pair<K,V>> kv_list;
 
 };
@@ -94,47 +201,115 @@ private:
 
 template<typename K, typename V>
 void HashTableCollection<K,V>::resize_and_rehash(){
-size_t newlength = 0; // creating new table
-size_t newcapacity = 2*table_capacity;
+size_t newcapacity = 2*table_capacity; // creating new table
 Node** newtable = new Node*[newcapacity];
-for(int i=0; i<newcapacity; i++){ 
+size_t* newlengths = new size_t[newcapacity];
+for(size_t i=0; i<newcapacity; i++){ 
     newtable[i] = nullptr;
+    newlengths[i] = 0;
 }
 std::hash<K> hash_fun;
-for(int i=0; i<table_capacity; i++){// iterating through old table to ge all nodes
-        if(hash_table[i] != nullptr){
-            Node* itr = hash_table[i];
-            while(itr!=nullptr){
-                size_t newindex = hash_fun(itr->key)%newcapacity;// finds new index for old node in new table
-
-                Node* ptr = new Node; //creates new node and adds it to the new table
-                ptr->key = itr->key; // I just realized that splicing this node into the new table could save us from having to delete it at all.
-                ptr->value = itr->value;
-                ptr->next = newtable[newindex];
-                newtable[newindex] = ptr;
-                newlength++;
-
-                itr = itr->next;
-            }
-        }
-}    
-for(int i=0; i<table_capacity; i++){// deletes all old nodes (there wouldnt be any if we spliced them)
-    if(hash_table[i]!=nullptr){
-        Node* ptr = hash_table[i];
-        Node* itr = ptr->next;
-        while(itr!=nullptr){
-            delete ptr;
-            ptr = itr;
-            itr = itr->next;
-        }
-        delete ptr;
+for(size_t i=0; i<table_capacity; i++){// iterating through old table to splice each node into the new table
+    Node* itr = hash_table[i];
+    while(itr!=nullptr){
+        Node* next = itr->next;
+        size_t newindex = hash_fun(itr->key)%newcapacity;// finds new index for old node in new table
+        itr->next = newtable[newindex];
+        newtable[newindex] = itr;
+        newlengths[newindex]++;
+        itr = next;
     }
-}
+}    
 delete[] hash_table;// deletes old table and sets new table parameters
+delete[] chain_lengths;
 hash_table = newtable; //replacing with new table
-length = newlength;
+chain_lengths = newlengths;
 table_capacity = newcapacity;
-newtable = nullptr;
+rebuild_stats();
+};
+
+template<typename K, typename V>
+void HashTableCollection<K,V>::rebuild_stats(){
+    histogram.clear();
+    histogram.add(0);
+    min_chain = 0;
+    max_chain = 0;
+    used_buckets = 0;
+    for(size_t i=0; i<table_capacity; i++){
+        size_t len = chain_lengths[i];
+        while(histogram.size() <= len){ // make room for a new longest chain
+            histogram.add(0);
+        }
+        size_t count;
+        histogram.get(len, count);
+        histogram.set(len, count+1);
+        if(len > 0){
+            used_buckets++;
+            if(min_chain == 0 || len < min_chain){
+                min_chain = len;
+            }
+            if(len > max_chain){
+                max_chain = len;
+            }
+        }
+    }
+};
+
+template<typename K, typename V>
+void HashTableCollection<K,V>::chain_grew(size_t index){
+    size_t len = chain_lengths[index]++;
+    size_t count;
+    if(histogram.size() <= len+1){
+        histogram.add(0);
+    }
+    histogram.get(len, count);
+    histogram.set(len, count-1);
+    histogram.get(len+1, count);
+    histogram.set(len+1, count+1);
+    if(len == 0){ // a new chain of length one is always the shortest
+        used_buckets++;
+        min_chain = 1;
+    }
+    else if(len == min_chain){
+        histogram.get(len, count);
+        if(count == 0){ // this was the last of the shortest chains
+            min_chain = len+1;
+        }
+    }
+    if(len+1 > max_chain){
+        max_chain = len+1;
+    }
+};
+
+template<typename K, typename V>
+void HashTableCollection<K,V>::chain_shrank(size_t index){
+    size_t len = chain_lengths[index]--;
+    size_t count;
+    histogram.get(len, count);
+    histogram.set(len, count-1);
+    histogram.get(len-1, count);
+    histogram.set(len-1, count+1);
+    histogram.get(len, count);
+    if(len == max_chain && count == 0){ // this chain is still the longest
+        max_chain = len-1;
+    }
+    if(len > 1){
+        if(len-1 < min_chain){
+            min_chain = len-1;
+        }
+    }
+    else{ // the chain is now empty
+        used_buckets--;
+        if(used_buckets == 0){
+            min_chain = 0;
+        }
+        else if(len == min_chain && count == 0){ // next shortest is above it
+            while(count == 0){
+                min_chain++;
+                histogram.get(min_chain, count);
+            }
+        }
+    }
 };
 
 template<typename K, typename V>
@@ -142,130 +317,345 @@ HashTableCollection<K,V>::HashTableCollection(){ //constructor
     length =0;
     table_capacity = 16;
     hash_table = new Node*[table_capacity];
+    chain_lengths = new size_t[table_capacity];
     for(int i=0; i<table_capacity; i++){ // sets every pointer to null ptr to indicate empty
         hash_table[i] = nullptr;
+        chain_lengths[i] = 0;
     }
+    rebuild_stats();
+    slab = nullptr;
+    slab_size = 0;
+    free_nodes = nullptr;
+    ordered_index = false;
+    skip_head = nullptr;
+    skip_level = 0;
+    skip_seed = 88172645463325252UL;
 };
 
     //destructor
 template<typename K, typename V>
 HashTableCollection<K,V>::~HashTableCollection(){ //destructor
-for(int i=0; i<table_capacity; i++){// deletes all old nodes 
-    if(hash_table[i]!=nullptr){
-        Node* ptr = hash_table[i];
-        Node* itr = ptr->next;
-        while(itr!=nullptr){
-            delete ptr;
-            ptr = itr;
-            itr = itr->next;
-        }
-        delete ptr;
-    }
-}
-  length = 0;
-  table_capacity = 0;
-  delete [] hash_table;
+  make_empty();
 };
 
     //copy constructor
 template<typename K, typename V>
 HashTableCollection<K,V>::HashTableCollection(const HashTableCollection <K,V>& rhs){
-    *this = rhs; // defers to assignment operator, we dont need to create new table beacuse AO does that
+    clone(rhs); // nothing to free yet, so copy straight in
 };
 
     // assignment operator
 template<typename K, typename V>
 HashTableCollection<K,V>& HashTableCollection<K,V>::operator=(const HashTableCollection<K,V>& rhs){
 if(this != &rhs){ // list1= list1
-  table_capacity = rhs.table_capacity;
-  hash_table = new Node*[table_capacity];// creating new hash table
-  for(int i=0; i<16; i++){
-    hash_table[i] = nullptr;
-  }
-  length=0;
-    for(int i=0; i<table_capacity; i++){ // moving old values in reverse order of the chains as to keep them in their orginal order
-        if(rhs.hash_table[i] != nullptr){
-            Node* ptr = rhs.hash_table[i];
-            int k = 0;
-            while(ptr->next != nullptr){// goes to last value in chain
-                ptr = ptr->next;
-                k++; // counts length of the chain
-            }    
-            add(ptr->key,ptr->value); // add last value
-            for(int q = 0; q < k; q++){ // iterates for the length of the chain
-                ptr = rhs.hash_table[i];
-                for(int t = 0; t < k-q-1; t++){// iterates to the next last value each time
-                ptr = ptr->next;
-                }
-                add(ptr->key,ptr->value);// adds the last value to the new table.
-            }
-        }
-    }    
+  make_empty();
+  clone(rhs);
   }
   //return lhs(this)
   return *this;
 };
 
-    //three public statistics functions
 template<typename K, typename V>
-size_t HashTableCollection<K,V>:: min_chain_length(){
-    size_t min=0;
-    if(size() > 0){
-        for(int i=0; i<table_capacity; i++){
-            if(hash_table[i] != nullptr){
-                Node* ptr = hash_table[i];
-                size_t count = 0;
-                while(ptr!=nullptr){
-                    ptr = ptr->next;
-                    count++;
-                }
-                if(min == 0){ //if min hasnt been set yet
-                    min = count;
-                }
-                else if(count < min){
-                    min = count;
-                }
-            }
-        }         
+bool HashTableCollection<K,V>::in_slab(const Node* node) const{
+    std::less<const Node*> before; // orders any two pointers, unlike <
+    return slab != nullptr && !before(node, slab) && before(node, slab + slab_size);
+};
+
+template<typename K, typename V>
+void HashTableCollection<K,V>::release_node(Node* node){
+    if(in_slab(node)){
+        node->key = K(); // let go of whatever the pair owned now
+        node->value = V();
+        node->next = free_nodes;
+        free_nodes = node;
+    }
+    else{
+        delete node;
     }
-    return min;
 };
 
 template<typename K, typename V>
-size_t HashTableCollection<K,V>::max_chain_length(){
-    size_t max=0;
-    if(size() > 0){
-        for(int i=0; i<table_capacity; i++){
-            if(hash_table[i] != nullptr){
-                Node* ptr = hash_table[i];
-                size_t count =1;
-                while(ptr!=nullptr){ // counts the length of each chain
-                    ptr = ptr->next;
-                    count++;
-                }
-                if(count > max){ //udpates the max chain value
-                    max = count;
-                }
+void HashTableCollection<K,V>::make_empty(){
+for(size_t i=0; i<table_capacity; i++){// deletes all old nodes 
+    Node* ptr = hash_table[i];
+    while(ptr!=nullptr){
+        Node* next = ptr->next;
+        if(!in_slab(ptr)){ // slab nodes go with the slab below
+            delete ptr;
+        }
+        ptr = next;
+    }
+}
+  length = 0;
+  table_capacity = 0;
+  delete [] hash_table;
+  delete [] chain_lengths;
+  delete [] slab;
+  free_towers();
+  hash_table = nullptr;
+  chain_lengths = nullptr;
+  slab = nullptr;
+  slab_size = 0;
+  free_nodes = nullptr; // these were all in the slab
+  skip_head = nullptr;
+};
+
+template<typename K, typename V>
+void HashTableCollection<K,V>::copy_buckets(const HashTableCollection<K,V>& rhs, size_t first,
+                                            size_t last, Node* slab_pos){
+    for(size_t i=first; i<last; i++){ // copy each chain into consecutive slab nodes, same order
+        Node* tail = nullptr;
+        hash_table[i] = nullptr;
+        for(Node* ptr = rhs.hash_table[i]; ptr != nullptr; ptr = ptr->next){
+            slab_pos->key = ptr->key;
+            slab_pos->value = ptr->value;
+            slab_pos->next = nullptr;
+            if(tail == nullptr){
+                hash_table[i] = slab_pos;
             }
-        }         
+            else{
+                tail->next = slab_pos;
+            }
+            tail = slab_pos++;
+        }
     }
-    return max;
 };
 
 template<typename K, typename V>
-double HashTableCollection<K,V>::avg_chain_length(){
-    double chain_count=0;
-    if(size() > 0){
-        for(int i=0; i<table_capacity; i++){// iterates through the table to find how many pointer are not null, meaning there is a chain
-            if(hash_table[i] != nullptr){ 
-                chain_count++;
+void HashTableCollection<K,V>::clone(const HashTableCollection<K,V>& rhs){
+    table_capacity = rhs.table_capacity;
+    load_factor_threshold = rhs.load_factor_threshold;
+    length = rhs.length;
+    hash_table = new Node*[table_capacity];
+    chain_lengths = new size_t[table_capacity];
+    for(size_t i=0; i<table_capacity; i++){
+        chain_lengths[i] = rhs.chain_lengths[i];
+    }
+    histogram = rhs.histogram; // statistics carry over unchanged
+    min_chain = rhs.min_chain;
+    max_chain = rhs.max_chain;
+    used_buckets = rhs.used_buckets;
+    slab_size = length;
+    slab = (length > 0) ? new Node[length] : nullptr; // one allocation for every node
+    free_nodes = nullptr;
+
+    size_t threads = std::thread::hardware_concurrency();
+    if(threads > MAX_CLONE_THREADS){
+        threads = MAX_CLONE_THREADS;
+    }
+    if(length < PARALLEL_CLONE_THRESHOLD || threads < 2){
+        copy_buckets(rhs, 0, table_capacity, slab);
+    }
+    else{ // split the buckets into ranges holding about the same number of nodes
+        std::thread* workers = new std::thread[threads];
+        size_t per_thread = length/threads + 1;
+        size_t first = 0;
+        size_t offset = 0;
+        size_t started = 0;
+        while(first < table_capacity){
+            size_t last = first;
+            size_t count = 0;
+            while(last < table_capacity && (count < per_thread || started == threads-1)){
+                count += chain_lengths[last++];
             }
-        }         
-    return length/chain_count; // calculates average chain length
+            workers[started++] = std::thread(&HashTableCollection<K,V>::copy_buckets, this,
+                                             std::cref(rhs), first, last, slab + offset);
+            offset += count;
+            first = last;
+        }
+        for(size_t t=0; t<started; t++){
+            workers[t].join();
+        }
+        delete [] workers;
+    }
+
+    ordered_index = false;
+    skip_head = nullptr;
+    skip_level = 0;
+    skip_seed = rhs.skip_seed;
+    if(rhs.ordered_index){ // rebuild the index in key order, keeping tower heights
+        skip_head = new_tower(nullptr, MAX_LEVEL);
+        Tower* last[MAX_LEVEL];
+        for(size_t l=0; l<MAX_LEVEL; l++){
+            last[l] = skip_head;
+        }
+        std::hash<K> hash_fun;
+        for(Tower* src = links(rhs.skip_head)[0]; src != nullptr; src = links(src)[0]){
+            size_t index = hash_fun(src->node->key)%table_capacity;
+            Node* copy = hash_table[index];
+            for(Node* ptr = rhs.hash_table[index]; ptr != src->node; ptr = ptr->next){ // same chain position
+                copy = copy->next;
+            }
+            Tower* tower = new_tower(copy, src->levels);
+            for(size_t l=0; l<tower->levels; l++){ // append to the end of each level
+                links(last[l])[l] = tower;
+                last[l] = tower;
+            }
+        }
+        skip_level = rhs.skip_level;
+        ordered_index = true;
+    }
+};
+
+    //three public statistics functions
+template<typename K, typename V>
+size_t HashTableCollection<K,V>:: min_chain_length() const{
+    return min_chain;
+};
+
+template<typename K, typename V>
+size_t HashTableCollection<K,V>::max_chain_length() const{
+    return max_chain;
+};
+
+template<typename K, typename V>
+double HashTableCollection<K,V>::avg_chain_length() const{
+    if(used_buckets > 0){
+        return length/(double)used_buckets; // calculates average chain length
     }
     return 0;
 };
 
+template<typename K, typename V>
+void HashTableCollection<K,V>::chain_histogram(ArrayList<size_t>& counts) const{
+    counts.clear();
+    for(size_t len=0; len<=max_chain; len++){ // longer entries are all zero
+        size_t count;
+        histogram.get(len, count);
+        counts.add(count);
+    }
+};
+
+template<typename K, typename V>
+size_t HashTableCollection<K,V>::bucket_count() const{
+    return table_capacity;
+};
+
+template<typename K, typename V>
+void HashTableCollection<K,V>::set_ordered_index(bool enable){
+    if(enable == ordered_index){
+        return;
+    }
+    if(enable){
+        skip_head = new_tower(nullptr, MAX_LEVEL);
+        skip_level = 0;
+        for(size_t i=0; i<table_capacity; i++){ // index every existing node
+            for(Node* ptr = hash_table[i]; ptr != nullptr; ptr = ptr->next){
+                skip_insert(ptr);
+            }
+        }
+    }
+    else{
+        free_towers();
+    }
+    ordered_index = enable;
+};
+
+template<typename K, typename V>
+bool HashTableCollection<K,V>::has_ordered_index() const{
+    return ordered_index;
+};
+
+template<typename K, typename V>
+typename HashTableCollection<K,V>::Tower**
+HashTableCollection<K,V>::links(const Tower* tower){
+    return reinterpret_cast<Tower**>(const_cast<Tower*>(tower) + 1);
+};
+
+template<typename K, typename V>
+typename HashTableCollection<K,V>::Tower*
+HashTableCollection<K,V>::new_tower(Node* node, size_t levels){
+    void* mem = ::operator new(sizeof(Tower) + levels*sizeof(Tower*)); // one allocation per tower
+    Tower* tower = new (mem) Tower;
+    tower->node = node;
+    tower->levels = levels;
+    for(size_t l=0; l<levels; l++){
+        links(tower)[l] = nullptr;
+    }
+    return tower;
+};
+
+template<typename K, typename V>
+void HashTableCollection<K,V>::free_towers(){
+    if(skip_head == nullptr){
+        return;
+    }
+    Tower* tower = links(skip_head)[0];
+    while(tower != nullptr){ // every tower is on the bottom level
+        Tower* next = links(tower)[0];
+        ::operator delete(tower);
+        tower = next;
+    }
+    ::operator delete(skip_head);
+    skip_head = nullptr;
+    skip_level = 0;
+};
+
+template<typename K, typename V>
+void HashTableCollection<K,V>::skip_insert(Node* node){
+    Tower* update[MAX_LEVEL];
+    Tower* x = skip_head;
+    for(size_t l=skip_level; l>0; l--){ // find the last tower before the key on each level
+        while(links(x)[l-1] != nullptr && links(x)[l-1]->node->key < node->key){
+            x = links(x)[l-1];
+        }
+        update[l-1] = x;
+    }
+    size_t levels = 1;
+    for(;;){ // each extra level with probability 1/4
+        skip_seed ^= skip_seed << 13;
+        skip_seed ^= skip_seed >> 7;
+        skip_seed ^= skip_seed << 17;
+        if((skip_seed & 3) != 0 || levels == MAX_LEVEL){
+            break;
+        }
+        levels++;
+    }
+    while(skip_level < levels){
+        update[skip_level++] = skip_head;
+    }
+    Tower* tower = new_tower(node, levels);
+    for(size_t l=0; l<levels; l++){ // splice the tower in
+        links(tower)[l] = links(update[l])[l];
+        links(update[l])[l] = tower;
+    }
+};
+
+template<typename K, typename V>
+void HashTableCollection<K,V>::skip_erase(Node* node){
+    Tower* x = skip_head;
+    Tower* tower = nullptr;
+    for(size_t l=skip_level; l>0; l--){
+        while(links(x)[l-1] != nullptr && links(x)[l-1]->node->key < node->key){ // x stays in front of the equal keys
+            x = links(x)[l-1];
+        }
+        Tower* y = x; // node's tower sits somewhere in the run of equal keys, if on this level
+        while(links(y)[l-1] != nullptr && links(y)[l-1]->node != node && !(node->key < links(y)[l-1]->node->key)){
+            y = links(y)[l-1];
+        }
+        if(links(y)[l-1] != nullptr && links(y)[l-1]->node == node){
+            tower = links(y)[l-1];
+            links(y)[l-1] = links(tower)[l-1];
+        }
+    }
+    ::operator delete(tower);
+    while(skip_level > 0 && links(skip_head)[skip_level-1] == nullptr){
+        skip_level--;
+    }
+};
+
+template<typename K, typename V>
+typename HashTableCollection<K,V>::Tower*
+HashTableCollection<K,V>::skip_lower_bound(const K& k) const{
+    Tower* x = skip_head;
+    for(size_t l=skip_level; l>0; l--){
+        while(links(x)[l-1] != nullptr && links(x)[l-1]->node->key < k){
+            x = links(x)[l-1];
+        }
+    }
+    return links(x)[0];
+};
+
 template<typename K, typename V>
 void HashTableCollection<K,V>:: add(const K& a_key, const V& a_val){
 if(length/table_capacity >= load_factor_threshold){ // if above threshold, rezise and rehash
@@ -275,11 +665,21 @@ std::hash<K> hash_fun; // finding hash index
 size_t code = hash_fun(a_key);
 size_t index = code%table_capacity; 
 
-Node* ptr = new Node; // placing node at hash index and moving pointers
+Node* ptr = free_nodes; // placing node at hash index and moving pointers
+if(ptr != nullptr){ // reuse a removed slab node first
+    free_nodes = ptr->next;
+}
+else{
+    ptr = new Node;
+}
 ptr->key = a_key;
 ptr->value = a_val;
 ptr->next = hash_table[index];
 hash_table[index] = ptr;
+if(ordered_index){
+    skip_insert(ptr);
+}
+chain_grew(index);
 length++;
 };
 
@@ -296,7 +696,11 @@ void HashTableCollection<K,V>:: remove(const K& a_key){
         if(hash_table[index]->next == nullptr){ //if there is only one key in the bucket
             if(ptr2->key == a_key){ //if it is the correct key
                 hash_table[index] = nullptr;
-                delete ptr2;
+                if(ordered_index){
+                    skip_erase(ptr2);
+                }
+                release_node(ptr2);
+                chain_shrank(index);
                 length--;
                 return;
             }
@@ -307,14 +711,22 @@ void HashTableCollection<K,V>:: remove(const K& a_key){
         Node* ptr = hash_table[index]->next; // there is at least 2 keys
         if(ptr2->key == a_key){ //if it is the first key
                 hash_table[index] = ptr;
-                delete ptr2;
+                if(ordered_index){
+                    skip_erase(ptr2);
+                }
+                release_node(ptr2);
+                chain_shrank(index);
                 length--;
                 return;
         }
         while(ptr!= nullptr){
             if(ptr->key == a_key){
                 ptr2->next=ptr->next;
-                delete ptr;
+                if(ordered_index){
+                    skip_erase(ptr);
+                }
+                release_node(ptr);
+                chain_shrank(index);
                 length--;
                 return;
             }
@@ -345,9 +757,13 @@ bool HashTableCollection<K,V>:: find(const K& search_key, V& the_val) const{
 
 template<typename K, typename V>
 void HashTableCollection<K,V>:: find(const K& k1, const K& k2, ArrayList<K>& keys) const{ 
+    keys.clear();
     if((k2 >= k1) && (size() > 0)){
-        while(keys.size()>0){// make return array empty
-            keys.remove(0);
+        if(ordered_index){ // walk the bottom level from the first key >= k1
+            for(Tower* t = skip_lower_bound(k1); t != nullptr && t->node->key <= k2; t = links(t)[0]){
+                keys.add(t->node->key);
+            }
+            return;
         }
         for(int i=0; i<table_capacity; i++){// go though entire table
             if(hash_table[i]!=nullptr){
@@ -365,10 +781,9 @@ void HashTableCollection<K,V>:: find(const K& k1, const K& k2, ArrayList<K>& key
 
 template<typename K, typename V>
 void HashTableCollection<K,V>:: keys(ArrayList<K>& all_keys) const{
+all_keys.clear();
 if(size() > 0){
-        while(all_keys.size()>0){
-            all_keys.remove(0);
-        }
+        all_keys.reserve(size());
         for(int i=0; i<table_capacity; i++){ // go through entire table
             if(hash_table[i]!=nullptr){
                 Node* ptr = hash_table[i];
@@ -383,12 +798,17 @@ if(size() > 0){
 
 template<typename K, typename V>
 void HashTableCollection<K,V>:: sort(ArrayList<K>& all_keys_sorted) const{ 
+    all_keys_sorted.clear();
     if((size() > 0)){
-      while(all_keys_sorted.size()>0){
-       all_keys_sorted.remove(0);
-      }
+     if(ordered_index){ // the bottom level is already in order
+       all_keys_sorted.reserve(size());
+       for(Tower* t = links(skip_head)[0]; t != nullptr; t = links(t)[0]){
+         all_keys_sorted.add(t->node->key);
+       }
+       return;
+     }
      keys(all_keys_sorted); // get all keys frome the table
-     all_keys_sorted.sort(); // sort the array with all the keys using quick sort
+     all_keys_sorted.sort(); // sorts in parallel once there are enough keys
    }
  };
 
@@ -12,9 +12,41 @@
 //     4 = find range
 //     5 = sort
 //     6 = statistics
-// Output consists of average operation times for different sized
-// input lists for both implementations, except for test 6, which
-// prints statistics information.
+//     7 = multi-threaded mixed read/write throughput
+//     8 = multi-threaded read-heavy throughput scaling
+//     9 = hash table chain statistics
+//    10 = keys into a reused output list
+//    11 = ArrayList sorts on sorted, reversed, random and duplicate input
+//    12 = ArrayList parallel sort scaling
+//    13 = ArrayList radix sort on integer and string keys
+//    14 = short range queries into ArrayList and SmallArrayList
+//    15 = batched versus one at a time adds
+//    16 = integer key find, linear scan versus tree crossover
+//    17 = find lookups on sorted array, tree and hash table
+//    18 = frozen (Eytzinger) lookups up to 10M integer keys
+//    19 = building a sorted array one add at a time, with and without
+//         an insert buffer
+//    20 = packed memory array adds and ordered scans
+//    21 = bounded range finds and range counts on a sorted array
+//    22 = sorted array finds with large values, pairs versus
+//         separate key and value arrays
+//    23 = many small maps, adaptive versus tree and hash table
+//    24 = frozen perfect hash lookups and build times
+//    25 = sorted array finds, binary search versus a learned index,
+//         on uniform and skewed keys
+//    26 = AVL tree memory, packed balance factors versus the old
+//         node layout with a height field
+// Output consists of one row per input size, after "# Column" lines
+// naming each column and its unit. The columns are average operation
+// times, except for test 6, which prints statistics information,
+// tests 7 and 8, which print operations per second for 1 to N worker
+// threads, test 9, which prints hash table chain statistics, test
+// 12, which prints sort times for 1 to N threads, tests 19 and 20,
+// which print the total time to build (and, for 20, to scan) each
+// collection, test 24, whose last column is the time to build the
+// perfect hash table, and test 25, whose last two columns are the
+// number of learned index segments. Test 26 is a memory report: it
+// prints heap bytes per pair rather than times.
 //----------------------------------------------------------------------
 
 
@@ -25,13 +57,22 @@
 #include <chrono>
 #include <string>
 #include <cassert>
+#include <thread>
+#include <mutex>
+#include <malloc.h>
 #include "collection.h"
+#include "small_array_list.h"
 #include "array_list_collection.h"
 #include "bin_search_collection.h"
 #include "hash_table_collection.h"
+#include "concurrent_hash_table_collection.h"
+#include "split_ordered_hash_collection.h"
 #include "bst_collection.h"
 #include "avl_collection.h"
 #include "rbt_collection.h"
+#include "pma_collection.h"
+#include "adaptive_collection.h"
+#include "frozen_hash_collection.h"
 
 using namespace std;
 using namespace std::chrono;
@@ -39,6 +80,7 @@ using namespace std::chrono;
 // Test generation params
 const int ITERATIONS = 3;       // runs to average
 const int SHUFFLINGS = 3;       // amount of "randomness"
+const size_t THREAD_OPS = 100000; // operations per worker thread
   
 // Implementation types
 const int ARRAYLIST = 0;
@@ -47,8 +89,32 @@ const int HASHTABLE = 2;
 const int BINSEARCHTREE = 3;
 const int AVLSEARCHTREE = 4;
 const int RBTSEARCHTREE = 5;
+const int CONCURRENTHASHTABLE = 6;
+const int SPLITORDEREDHASHTABLE = 7;
+const int ORDEREDHASHTABLE = 8;
+const int PACKEDMEMORYARRAY = 9;
+const int ADAPTIVE = 10;
+
+// A value big enough that a key and its value fill two cache lines
+struct LargeValue {
+  char bytes[120];
+  // ArrayList<LargeValue> needs an ordering (for its sorts) to compile
+  bool operator<(const LargeValue& rhs) const {return bytes[0] < rhs.bytes[0];}
+};
+
+// The AVLCollection node layout before balance factors were packed
+// into the left pointer
+template<typename K, typename V>
+struct LegacyAVLNode {
+  K key;
+  V value;
+  int height;
+  LegacyAVLNode* left;
+  LegacyAVLNode* right;
+};
 
 // Helper functions: 
+Collection<string,int>* create_collection(int type);
 unsigned long sum(unsigned long array[], size_t n);
 void create_pairs(pair<string,int> array[], size_t n); 
 string get_ith_key(size_t i, size_t n);
@@ -61,6 +127,27 @@ double find_value(pair<string,int> array[], size_t size, int type);
 double find_range(pair<string,int> array[], size_t size, int type);
 double sort(pair<string,int> array[], size_t size, int type);
 size_t stats(pair<string,int> array[], size_t size, int type);
+void hash_stats(pair<string,int> array[], size_t size, bool print_histogram);
+double reused_keys(pair<string,int> array[], size_t size, bool remove_each);
+double list_sort(size_t size, int shape, int method);
+double parallel_list_sort(size_t size, size_t threads);
+double radix_list_sort(pair<string,int> array[], size_t size, bool strings,
+                       int method);
+double short_ranges(pair<string,int> array[], size_t size, bool small_list);
+double batch_add(pair<string,int> array[], size_t size, int type, bool batched);
+double int_finds(size_t size, int type);
+double lookups(pair<string,int> array[], size_t size, int type);
+void frozen_lookups(size_t size, double results[3]);
+void build_times(size_t size, double results[3]);
+void pma_times(size_t size, double results[6]);
+void range_counts(pair<string,int> array[], size_t size, double results[3]);
+void large_value_lookups(size_t size, double results[3]);
+double small_maps(size_t size, int type);
+void perfect_hash_lookups(size_t size, double results[4]);
+void learned_lookups(size_t size, double results[6]);
+void avl_memory(pair<string,int> array[], size_t size, double results[4]);
+double mixed_ops(pair<string,int> array[], size_t size, size_t threads,
+                 int read_percent, int type);
 
 
 // Test driver:
@@ -69,7 +156,7 @@ int main(int argc, char* argv[])
 
   // check command line args
   if (argc != 2) {
-    cerr << "usage: " << argv[0] << " test-number (1-6)" << endl;
+    cerr << "usage: " << argv[0] << " test-number (1-26)" << endl;
     exit(1);
   }
   string test_number = argv[1];
@@ -147,15 +234,19 @@ int main(int argc, char* argv[])
          << "# Column 2 = Avg time for HashTableCollection find-range function\n"
          << "# Column 3 = Avg time for AVLCollection find-range function\n"
          << "# Column 4 = Avg time for RBTCollection find-range function\n"
+         << "# Column 5 = Avg time for HashTableCollection find-range function"
+         << " with the ordered index\n"
          << "# All times are measured in microseconds" << endl;
     for (size_t size = START; size <= STOP; size += STEP) {
       double avg1 = find_range(array, size, HASHTABLE);
       double avg2 = find_range(array, size, AVLSEARCHTREE);
       double avg3 = find_range(array, size, RBTSEARCHTREE);
+      double avg4 = find_range(array, size, ORDEREDHASHTABLE);
       cout << size << " "
            << (avg1/1000.0) << " " 
            << (avg2/1000.0) << " "
-           << (avg3/1000.0) << endl;
+           << (avg3/1000.0) << " "
+           << (avg4/1000.0) << endl;
     }
   }
   // test 5: sort operation
@@ -164,15 +255,19 @@ int main(int argc, char* argv[])
          << "# Column 2 = Avg time for HashTableCollection sort function\n"
          << "# Column 3 = Avg time for AVLCollection sort function\n"
          << "# Column 4 = Avg time for RBTCollection sort function\n"
+         << "# Column 5 = Avg time for HashTableCollection sort function"
+         << " with the ordered index\n"
          << "# All times are measured in microseconds" << endl;
     for (size_t size = START; size <= STOP; size += STEP) {
       double avg1 = sort(array, size, HASHTABLE);
       double avg2 = sort(array, size, AVLSEARCHTREE);
       double avg3 = sort(array, size, RBTSEARCHTREE);
+      double avg4 = sort(array, size, ORDEREDHASHTABLE);
       cout << size << " "
            << (avg1/1000.0) << " "
            << (avg2/1000.0) << " "
-           << (avg3/1000.0) << endl;
+           << (avg3/1000.0) << " "
+           << (avg4/1000.0) << endl;
     }
   }
   // test 6: statistics information
@@ -188,6 +283,367 @@ int main(int argc, char* argv[])
            << height2 << endl;
     }
   }
+  // test 7: multi-threaded mixed read/write throughput
+  else if (test_number.compare("7") == 0) {
+    size_t max_threads = thread::hardware_concurrency();
+    if (max_threads < 4)
+      max_threads = 4;
+    cout << "# Column 1 = Number of worker threads\n"
+         << "# Column 2 = Ops/sec for HashTableCollection behind one mutex\n"
+         << "# Column 3 = Ops/sec for ConcurrentHashTableCollection\n"
+         << "# Each thread does " << THREAD_OPS << " operations, "
+         << "80% find and 20% add/remove" << endl;
+    for (size_t threads = 1; threads <= max_threads; ++threads) {
+      double ops1 = mixed_ops(array, STOP/2, threads, 80, HASHTABLE);
+      double ops2 = mixed_ops(array, STOP/2, threads, 80, CONCURRENTHASHTABLE);
+      cout << threads << " "
+           << ops1 << " "
+           << ops2 << endl;
+    }
+  }
+  // test 8: multi-threaded read-heavy throughput scaling
+  else if (test_number.compare("8") == 0) {
+    size_t max_threads = thread::hardware_concurrency();
+    if (max_threads < 4)
+      max_threads = 4;
+    cout << "# Column 1 = Number of worker threads\n"
+         << "# Column 2 = Ops/sec for HashTableCollection behind one mutex\n"
+         << "# Column 3 = Ops/sec for ConcurrentHashTableCollection\n"
+         << "# Column 4 = Ops/sec for SplitOrderedHashCollection\n"
+         << "# Each thread does " << THREAD_OPS << " operations, "
+         << "95% find and 5% add/remove" << endl;
+    for (size_t threads = 1; threads <= max_threads; ++threads) {
+      double ops1 = mixed_ops(array, STOP/2, threads, 95, HASHTABLE);
+      double ops2 = mixed_ops(array, STOP/2, threads, 95, CONCURRENTHASHTABLE);
+      double ops3 = mixed_ops(array, STOP/2, threads, 95, SPLITORDEREDHASHTABLE);
+      cout << threads << " "
+           << ops1 << " "
+           << ops2 << " "
+           << ops3 << endl;
+    }
+  }
+  // test 9: hash table chain statistics
+  else if (test_number.compare("9") == 0) {
+    cout << "# Column 1 = Input data size\n"
+         << "# Column 2 = Number of buckets\n"
+         << "# Column 3 = Min chain length\n"
+         << "# Column 4 = Max chain length\n"
+         << "# Column 5 = Avg chain length\n"
+         << "# Column 6 = Avg time to read all three statistics (ns)" << endl;
+    for (size_t size = START; size <= STOP; size += STEP)
+      hash_stats(array, size, size + STEP > STOP);
+  }
+  // test 10: keys into a reused output list
+  else if (test_number.compare("10") == 0) {
+    const size_t REUSE_STOP = 20000;
+    const size_t REUSE_STEP = 2000;
+    cout << "# Column 1 = Input data size\n"
+         << "# Column 2 = Avg time for RBTCollection keys into a reused list\n"
+         << "# Column 3 = Same, first emptying the list with remove(0)"
+         << " (the old approach)\n"
+         << "# All times are measured in milliseconds" << endl;
+    for (size_t size = START; size <= REUSE_STOP; size += REUSE_STEP) {
+      double avg1 = reused_keys(array, size, false);
+      double avg2 = reused_keys(array, size, true);
+      cout << size << " "
+           << (avg1/1000.0) << " "
+           << (avg2/1000.0) << endl;
+    }
+  }
+  // test 11: ArrayList sort and merge_sort versus the original quick sort
+  else if (test_number.compare("11") == 0) {
+    const size_t SORT_STOP = 20000;
+    const size_t SORT_STEP = 2000;
+    const char* shapes[] = {"sorted", "reversed", "random", "duplicate"};
+    const char* methods[] = {"quick_sort", "sort", "merge_sort"};
+    cout << "# Column 1 = Input data size\n";
+    for (int shape = 0; shape < 4; ++shape)
+      for (int method = 0; method < 3; ++method)
+        cout << "# Column " << (3*shape + method + 2) << " = Avg time for "
+             << methods[method] << " on " << shapes[shape] << " input\n";
+    cout << "# All times are measured in milliseconds" << endl;
+    for (size_t size = START; size <= SORT_STOP; size += SORT_STEP) {
+      cout << size;
+      for (int shape = 0; shape < 4; ++shape)
+        for (int method = 0; method < 3; ++method)
+          cout << " " << (list_sort(size, shape, method)/1000.0);
+      cout << endl;
+    }
+  }
+  // test 12: ArrayList parallel sort scaling
+  else if (test_number.compare("12") == 0) {
+    const size_t SORT_SIZE = 2000000;
+    size_t max_threads = thread::hardware_concurrency();
+    if (max_threads < 4)
+      max_threads = 4;
+    cout << "# Column 1 = Number of sort threads\n"
+         << "# Column 2 = Avg time for parallel_sort of " << SORT_SIZE
+         << " random ints\n"
+         << "# All times are measured in milliseconds" << endl;
+    for (size_t threads = 1; threads <= max_threads; ++threads) {
+      double avg = parallel_list_sort(SORT_SIZE, threads);
+      cout << threads << " "
+           << (avg/1000.0) << endl;
+    }
+  }
+  // test 13: ArrayList radix sort versus the comparison sorts
+  else if (test_number.compare("13") == 0) {
+    const size_t RADIX_STOP = 100000;
+    cout << "# Column 1 = Input data size\n"
+         << "# Column 2 = Avg time for quick_sort of integer keys\n"
+         << "# Column 3 = Avg time for sort of integer keys\n"
+         << "# Column 4 = Avg time for radix_sort of integer keys\n"
+         << "# Column 5 = Avg time for quick_sort of string keys\n"
+         << "# Column 6 = Avg time for sort of string keys\n"
+         << "# Column 7 = Avg time for radix_sort of string keys\n"
+         << "# All times are measured in milliseconds" << endl;
+    for (size_t size = START; size <= RADIX_STOP; size += STEP) {
+      cout << size;
+      for (int strings = 0; strings < 2; ++strings)
+        for (int method = 0; method < 3; ++method)
+          cout << " " << (radix_list_sort(array, size, strings, method)/1000.0);
+      cout << endl;
+    }
+  }
+  // test 14: short range queries into a fresh output list
+  else if (test_number.compare("14") == 0) {
+    cout << "# Column 1 = Input data size\n"
+         << "# Column 2 = Avg time for RBTCollection 8-key range find into"
+         << " a new ArrayList\n"
+         << "# Column 3 = Same, into a new SmallArrayList<string,16>\n"
+         << "# All times are measured in microseconds" << endl;
+    for (size_t size = START + STEP; size <= STOP; size += STEP) {
+      double avg1 = short_ranges(array, size, false);
+      double avg2 = short_ranges(array, size, true);
+      cout << size << " "
+           << avg1 << " "
+           << avg2 << endl;
+    }
+  }
+  // test 15: adding a batch of pairs at once
+  else if (test_number.compare("15") == 0) {
+    cout << "# Column 1 = Input data size\n"
+         << "# Column 2 = Avg time for BinSearchCollection adding " << STEP/10
+         << " pairs one at a time\n"
+         << "# Column 3 = Same, as one batch\n"
+         << "# Column 4 = Avg time for ArrayListCollection adding them one at"
+         << " a time\n"
+         << "# Column 5 = Same, as one batch\n"
+         << "# All times are measured in milliseconds" << endl;
+    for (size_t size = START; size < STOP; size += STEP) {
+      double avg1 = batch_add(array, size, BINSEARCH, false);
+      double avg2 = batch_add(array, size, BINSEARCH, true);
+      double avg3 = batch_add(array, size, ARRAYLIST, false);
+      double avg4 = batch_add(array, size, ARRAYLIST, true);
+      cout << size << " "
+           << (avg1/1000.0) << " "
+           << (avg2/1000.0) << " "
+           << (avg3/1000.0) << " "
+           << (avg4/1000.0) << endl;
+    }
+  }
+  // test 16: integer key lookups on small collections
+  else if (test_number.compare("16") == 0) {
+    cout << "# Column 1 = Number of integer keys\n"
+         << "# Column 2 = Avg time for ArrayListCollection<int,int> find\n"
+         << "# Column 3 = Avg time for RBTCollection<int,int> find\n"
+         << "# Column 4 = Avg time for HashTableCollection<int,int> find\n"
+         << "# All times are measured in nanoseconds per find" << endl;
+    for (size_t size = 1; size <= 4096; size *= 2) {
+      double avg1 = int_finds(size, ARRAYLIST);
+      double avg2 = int_finds(size, RBTSEARCHTREE);
+      double avg3 = int_finds(size, HASHTABLE);
+      cout << size << " "
+           << avg1 << " "
+           << avg2 << " "
+           << avg3 << endl;
+    }
+  }
+  // test 17: find lookups
+  else if (test_number.compare("17") == 0) {
+    cout << "# Column 1 = Input data size\n"
+         << "# Column 2 = Avg time for BinSearchCollection find\n"
+         << "# Column 3 = Avg time for RBTCollection find\n"
+         << "# Column 4 = Avg time for HashTableCollection find\n"
+         << "# All times are measured in nanoseconds per find" << endl;
+    for (size_t size = START + STEP; size <= STOP; size += STEP) {
+      double avg1 = lookups(array, size, BINSEARCH);
+      double avg2 = lookups(array, size, RBTSEARCHTREE);
+      double avg3 = lookups(array, size, HASHTABLE);
+      cout << size << " "
+           << avg1 << " "
+           << avg2 << " "
+           << avg3 << endl;
+    }
+  }
+  // test 18: frozen lookups on large integer collections
+  else if (test_number.compare("18") == 0) {
+    cout << "# Column 1 = Number of integer keys\n"
+         << "# Column 2 = Avg time for BinSearchCollection find (sorted)\n"
+         << "# Column 3 = Avg time for BinSearchCollection find (frozen)\n"
+         << "# Column 4 = Avg time for RBTCollection find\n"
+         << "# All times are measured in nanoseconds per find" << endl;
+    for (size_t size = 1000; size <= 10000000; size *= 10) {
+      for (size_t mult = 1; mult <= 5 && size * mult <= 10000000; mult += 4) {
+        double results[3];
+        frozen_lookups(size * mult, results);
+        cout << size * mult << " "
+             << results[0] << " "
+             << results[1] << " "
+             << results[2] << endl;
+      }
+    }
+  }
+  // test 19: building a collection one add at a time
+  else if (test_number.compare("19") == 0) {
+    cout << "# Column 1 = Number of integer keys\n"
+         << "# Column 2 = Time for BinSearchCollection to add them all\n"
+         << "# Column 3 = Same, with the insert buffer on\n"
+         << "# Column 4 = Same, for RBTCollection\n"
+         << "# All times are measured in milliseconds" << endl;
+    for (size_t size = 1000; size <= 256000; size *= 2) {
+      double results[3];
+      build_times(size, results);
+      cout << size << " "
+           << (results[0]/1000.0) << " "
+           << (results[1]/1000.0) << " "
+           << (results[2]/1000.0) << endl;
+    }
+  }
+  // test 20: packed memory array adds and scans
+  else if (test_number.compare("20") == 0) {
+    cout << "# Column 1 = Number of integer keys\n"
+         << "# Column 2 = Time for BinSearchCollection (insert buffer on)"
+         << " to add them all\n"
+         << "# Column 3 = Same, for PMACollection\n"
+         << "# Column 4 = Same, for RBTCollection\n"
+         << "# Column 5 = Time for BinSearchCollection (insert buffer on)"
+         << " to find the range of every key\n"
+         << "# Column 6 = Same, for PMACollection\n"
+         << "# Column 7 = Same, for RBTCollection\n"
+         << "# All times are measured in milliseconds" << endl;
+    for (size_t size = 1000; size <= 1024000; size *= 2) {
+      double results[6];
+      pma_times(size, results);
+      cout << size;
+      for (int r = 0; r < 6; ++r)
+        cout << " " << (results[r]/1000.0);
+      cout << endl;
+    }
+  }
+  // test 21: bounded range finds and counts
+  else if (test_number.compare("21") == 0) {
+    cout << "# Column 1 = Input data size\n"
+         << "# Column 2 = Avg time for BinSearchCollection to find the first"
+         << " 10 keys\n"
+         << "# Column 3 = Avg time for BinSearchCollection to count the middle"
+         << " 20% of the keys\n"
+         << "# Column 4 = Avg time for BinSearchCollection to find the middle"
+         << " 20% of the keys\n"
+         << "# All times are measured in microseconds" << endl;
+    for (size_t size = START + STEP; size <= STOP; size += STEP) {
+      double results[3];
+      range_counts(array, size, results);
+      cout << size << " "
+           << (results[0]/1000.0) << " "
+           << (results[1]/1000.0) << " "
+           << (results[2]/1000.0) << endl;
+    }
+  }
+  // test 22: finds with large values
+  else if (test_number.compare("22") == 0) {
+    cout << "# Column 1 = Number of integer keys\n"
+         << "# Column 2 = Avg time for a binary search find over an array of"
+         << " pair<int,LargeValue> (the old layout)\n"
+         << "# Column 3 = Avg time for BinSearchCollection<int,LargeValue>"
+         << " find\n"
+         << "# Column 4 = Avg time for BinSearchCollection<int,int> find\n"
+         << "# LargeValue is " << sizeof(LargeValue) << " bytes\n"
+         << "# All times are measured in nanoseconds per find" << endl;
+    for (size_t size = 1000; size <= 4096000; size *= 4) {
+      double results[3];
+      large_value_lookups(size, results);
+      cout << size << " "
+           << results[0] << " "
+           << results[1] << " "
+           << results[2] << endl;
+    }
+  }
+  // test 23: many small maps
+  else if (test_number.compare("23") == 0) {
+    cout << "# Column 1 = Number of integer keys per map\n"
+         << "# Column 2 = Avg time for AdaptiveCollection<int,int>\n"
+         << "# Column 3 = Avg time for RBTCollection<int,int>\n"
+         << "# Column 4 = Avg time for HashTableCollection<int,int>\n"
+         << "# Each map is created, filled, searched for every key and"
+         << " emptied again\n"
+         << "# All times are measured in nanoseconds per operation" << endl;
+    for (size_t size = 1; size <= 128; size *= 2) {
+      double avg1 = small_maps(size, ADAPTIVE);
+      double avg2 = small_maps(size, RBTSEARCHTREE);
+      double avg3 = small_maps(size, HASHTABLE);
+      cout << size << " "
+           << avg1 << " "
+           << avg2 << " "
+           << avg3 << endl;
+    }
+  }
+  // test 24: frozen perfect hash
+  else if (test_number.compare("24") == 0) {
+    cout << "# Column 1 = Number of integer keys\n"
+         << "# Column 2 = Avg time for HashTableCollection find (ns)\n"
+         << "# Column 3 = Avg time for BinSearchCollection find, frozen (ns)\n"
+         << "# Column 4 = Avg time for FrozenHashCollection find (ns)\n"
+         << "# Column 5 = Time to build the FrozenHashCollection from the"
+         << " hash table (ms)" << endl;
+    for (size_t size = 1000; size <= 4096000; size *= 4) {
+      double results[4];
+      perfect_hash_lookups(size, results);
+      cout << size << " "
+           << results[0] << " "
+           << results[1] << " "
+           << results[2] << " "
+           << results[3] << endl;
+    }
+  }
+  // test 25: learned index
+  else if (test_number.compare("25") == 0) {
+    cout << "# Column 1 = Number of integer keys\n"
+         << "# Column 2 = Avg time for binary search find, uniform keys (ns)\n"
+         << "# Column 3 = Avg time for learned index find, uniform keys (ns)\n"
+         << "# Column 4 = Avg time for binary search find, skewed keys (ns)\n"
+         << "# Column 5 = Avg time for learned index find, skewed keys (ns)\n"
+         << "# Column 6 = Learned index segments, uniform keys\n"
+         << "# Column 7 = Learned index segments, skewed keys" << endl;
+    for (size_t size = 1000; size <= 4096000; size *= 4) {
+      double results[6];
+      learned_lookups(size, results);
+      cout << size << " "
+           << results[0] << " "
+           << results[1] << " "
+           << results[2] << " "
+           << results[3] << " "
+           << results[4] << " "
+           << results[5] << endl;
+    }
+  }
+  // test 26: AVL node memory
+  else if (test_number.compare("26") == 0) {
+    cout << "# Column 1 = Number of keys\n"
+         << "# Column 2 = Heap bytes per pair, AVLCollection<int,int>\n"
+         << "# Column 3 = Heap bytes per pair, old layout <int,int>\n"
+         << "# Column 4 = Heap bytes per pair, AVLCollection<string,int>\n"
+         << "# Column 5 = Heap bytes per pair, old layout <string,int>" << endl;
+    for (size_t size = 1000; size <= 256000; size *= 4) {
+      double results[4];
+      avl_memory(array, size, results);
+      cout << size << " "
+           << results[0] << " "
+           << results[1] << " "
+           << results[2] << " "
+           << results[3] << endl;
+    }
+  }
   else {
     cerr << "error: invalid test number" << endl;
     exit(1);
@@ -281,6 +737,36 @@ string get_ith_key(size_t i, size_t n)
 }        
 
 
+// Creates an empty collection of the given implementation type
+Collection<string,int>* create_collection(int type)
+{
+  if (type == ARRAYLIST)
+    return new ArrayListCollection<string,int>;
+  else if (type == BINSEARCH)
+    return new BinSearchCollection<string,int>;
+  else if (type == HASHTABLE)
+    return new HashTableCollection<string,int>;
+  else if (type == BINSEARCHTREE)
+    return new BSTCollection<string,int>;
+  else if (type == AVLSEARCHTREE)
+    return new AVLCollection<string,int>;
+  else if (type == RBTSEARCHTREE)
+    return new RBTCollection<string,int>;
+  else if (type == CONCURRENTHASHTABLE)
+    return new ConcurrentHashTableCollection<string,int>;
+  else if (type == SPLITORDEREDHASHTABLE)
+    return new SplitOrderedHashCollection<string,int>;
+  else if (type == ORDEREDHASHTABLE) {
+    HashTableCollection<string,int>* collection = new HashTableCollection<string,int>;
+    collection->set_ordered_index(true);
+    return collection;
+  }
+  else if (type == PACKEDMEMORYARRAY)
+    return new PMACollection<string,int>;
+  return nullptr;
+}
+
+
 void print(const Collection<string,int>& coll)
 {
   cout << "{";
@@ -300,19 +786,7 @@ void print(const Collection<string,int>& coll)
 double add(pair<string,int> array[], size_t size, int type)
 {
   unsigned long times[ITERATIONS]; 
-  Collection<string,int>* collection;
-  if (type == ARRAYLIST)
-    collection = new ArrayListCollection<string,int>;
-  else if (type == BINSEARCH)
-    collection = new BinSearchCollection<string,int>;
-  else if (type == HASHTABLE)
-    collection = new HashTableCollection<string,int>;
-  else if (type == BINSEARCHTREE)
-    collection = new BSTCollection<string,int>;    
-  else if (type == AVLSEARCHTREE)
-    collection = new AVLCollection<string,int>;
-  else if (type == RBTSEARCHTREE)
-    collection = new RBTCollection<string,int>;
+  Collection<string,int>* collection = create_collection(type);
   for (size_t i = 0; i < size; ++i)
     collection->add(array[i].first, array[i].second);
   if (type == RBTSEARCHTREE)
@@ -332,19 +806,7 @@ double add(pair<string,int> array[], size_t size, int type)
 double remove(pair<string,int> array[], size_t size, int type)
 {
   unsigned long times[ITERATIONS]; 
-  Collection<string,int>* collection;
-  if (type == ARRAYLIST)
-    collection = new ArrayListCollection<string,int>;
-  else if (type == BINSEARCH)
-    collection = new BinSearchCollection<string,int>;
-  else if (type == HASHTABLE)
-    collection = new HashTableCollection<string,int>;
-  else if (type == BINSEARCHTREE)
-    collection = new BSTCollection<string,int>;    
-  else if (type == AVLSEARCHTREE)
-    collection = new AVLCollection<string,int>;    
-  else if (type == RBTSEARCHTREE)
-    collection = new RBTCollection<string,int>;
+  Collection<string,int>* collection = create_collection(type);
   for (size_t i = 0; i < size; ++i)
     collection->add(array[i].first, array[i].second);
   if (type == RBTSEARCHTREE)
@@ -367,19 +829,7 @@ double remove(pair<string,int> array[], size_t size, int type)
 double find_value(pair<string,int> array[], size_t size, int type)
 {
   unsigned long times[ITERATIONS]; 
-  Collection<string,int>* collection;
-  if (type == ARRAYLIST)
-    collection = new ArrayListCollection<string,int>;
-  else if (type == BINSEARCH)
-    collection = new BinSearchCollection<string,int>;
-  else if (type == HASHTABLE)
-    collection = new HashTableCollection<string,int>;
-  else if (type == BINSEARCHTREE)
-    collection = new BSTCollection<string,int>;    
-  else if (type == AVLSEARCHTREE)
-    collection = new AVLCollection<string,int>;    
-  else if (type == RBTSEARCHTREE)
-    collection = new RBTCollection<string,int>;
+  Collection<string,int>* collection = create_collection(type);
   for (size_t i = 0; i < size; ++i)
     collection->add(array[i].first, array[i].second);
   if (type == RBTSEARCHTREE)
@@ -399,19 +849,7 @@ double find_value(pair<string,int> array[], size_t size, int type)
 double find_range(pair<string,int> array[], size_t size, int type)
 {
   unsigned long times[ITERATIONS]; 
-  Collection<string,int>* collection;
-  if (type == ARRAYLIST)
-    collection = new ArrayListCollection<string,int>;
-  else if (type == BINSEARCH)
-    collection = new BinSearchCollection<string,int>;
-  else if (type == HASHTABLE)
-    collection = new HashTableCollection<string,int>;
-  else if (type == BINSEARCHTREE)
-    collection = new BSTCollection<string,int>;    
-  else if (type == AVLSEARCHTREE)
-    collection = new AVLCollection<string,int>;    
-  else if (type == RBTSEARCHTREE)
-    collection = new RBTCollection<string,int>;
+  Collection<string,int>* collection = create_collection(type);
   for (size_t i = 0; i < size; ++i)
     collection->add(array[i].first, array[i].second);
   if (type == RBTSEARCHTREE)
@@ -435,19 +873,7 @@ double find_range(pair<string,int> array[], size_t size, int type)
 double sort(pair<string,int> array[], size_t size, int type)
 {
   unsigned long times[ITERATIONS]; 
-  Collection<string,int>* collection;
-  if (type == ARRAYLIST)
-    collection = new ArrayListCollection<string,int>;
-  else if (type == BINSEARCH)
-    collection = new BinSearchCollection<string,int>;
-  else if (type == HASHTABLE)
-    collection = new HashTableCollection<string,int>;
-  else if (type == BINSEARCHTREE)
-    collection = new BSTCollection<string,int>;    
-  else if (type == AVLSEARCHTREE)
-    collection = new AVLCollection<string,int>;    
-  else if (type == RBTSEARCHTREE)
-    collection = new RBTCollection<string,int>;
+  Collection<string,int>* collection = create_collection(type);
   for (size_t i = 0; i < size; ++i)
     collection->add(array[i].first, array[i].second);
   if (type == RBTSEARCHTREE)
@@ -501,4 +927,786 @@ size_t stats(pair<string,int> array[], size_t size, int type)
 }
 
 
+// Prints the chain statistics of a HashTableCollection holding size
+// pairs, along with how long reading them takes, and optionally the
+// chain length histogram as comment lines.
+void hash_stats(pair<string,int> array[], size_t size, bool print_histogram)
+{
+  const size_t POLLS = 1000;
+  HashTableCollection<string,int> collection;
+  for (size_t i = 0; i < size; ++i)
+    collection.add(array[i].first, array[i].second);
+  size_t min = 0, max = 0;
+  double avg = 0;
+  auto start = high_resolution_clock::now();
+  for (size_t i = 0; i < POLLS; ++i) {
+    min += collection.min_chain_length();
+    max += collection.max_chain_length();
+    avg += collection.avg_chain_length();
+  }
+  auto end = high_resolution_clock::now();
+  double poll_ns = duration_cast<nanoseconds>(end - start).count() / (POLLS*1.0);
+  cout << size << " "
+       << collection.bucket_count() << " "
+       << (min / POLLS) << " "
+       << (max / POLLS) << " "
+       << (avg / POLLS) << " "
+       << poll_ns << endl;
+  if (print_histogram) {
+    ArrayList<size_t> counts;
+    collection.chain_histogram(counts);
+    cout << "# Chain length histogram for " << size << " pairs:" << endl;
+    for (size_t len = 0; len < counts.size(); ++len) {
+      size_t count = 0;
+      counts.get(len, count);
+      cout << "#   " << len << " " << count << endl;
+    }
+  }
+}
+
+
+// Times keys() on an RBTCollection of size pairs into an output list
+// that already holds the previous call's keys. With remove_each the
+// list is first emptied one remove(0) at a time, as every collection
+// used to do before ArrayList had clear().
+double reused_keys(pair<string,int> array[], size_t size, bool remove_each)
+{
+  unsigned long times[ITERATIONS];
+  Collection<string,int>* collection = create_collection(RBTSEARCHTREE);
+  for (size_t i = 0; i < size; ++i)
+    collection->add(array[i].first, array[i].second);
+  ArrayList<string> keys;
+  collection->keys(keys);
+  for (size_t i = 0; i < ITERATIONS; ++i) {
+    auto start = high_resolution_clock::now();
+    if (remove_each)
+      while (keys.size() > 0)
+        keys.remove(0);
+    collection->keys(keys);
+    auto end = high_resolution_clock::now();
+    assert(keys.size() == size);
+    times[i] = duration_cast<microseconds>(end - start).count();
+  }
+  delete collection;
+  return sum(times, ITERATIONS) / (ITERATIONS*1.0);
+}
+
+
+// Sorts an ArrayList of size ints in the given shape (0 = sorted,
+// 1 = reversed, 2 = random, 3 = only 16 distinct values) with the
+// original quick_sort (method 0), sort (method 1) or merge_sort
+// (method 2).
+double list_sort(size_t size, int shape, int method)
+{
+  unsigned long times[ITERATIONS];
+  for (size_t i = 0; i < ITERATIONS; ++i) {
+    ArrayList<int> list;
+    list.reserve(size);
+    unsigned long seed = 88172645463325252UL + i;
+    for (size_t j = 0; j < size; ++j) {
+      seed ^= seed << 13;
+      seed ^= seed >> 7;
+      seed ^= seed << 17;
+      if (shape == 0) list.add(j);
+      else if (shape == 1) list.add(size - j);
+      else if (shape == 2) list.add(seed % 1000000);
+      else list.add(seed % 16);
+    }
+    auto start = high_resolution_clock::now();
+    if (method == 0)
+      list.quick_sort();
+    else if (method == 1)
+      list.sort();
+    else
+      list.merge_sort();
+    auto end = high_resolution_clock::now();
+    times[i] = duration_cast<microseconds>(end - start).count();
+  }
+  return sum(times, ITERATIONS) / (ITERATIONS*1.0);
+}
+
+// Sorts an ArrayList of size random ints with parallel_sort on the
+// given number of threads.
+double parallel_list_sort(size_t size, size_t threads)
+{
+  unsigned long times[ITERATIONS];
+  for (size_t i = 0; i < ITERATIONS; ++i) {
+    ArrayList<int> list;
+    list.reserve(size);
+    unsigned long seed = 88172645463325252UL + i;
+    for (size_t j = 0; j < size; ++j) {
+      seed ^= seed << 13;
+      seed ^= seed >> 7;
+      seed ^= seed << 17;
+      list.add(seed % 100000000);
+    }
+    auto start = high_resolution_clock::now();
+    list.parallel_sort(threads);
+    auto end = high_resolution_clock::now();
+    times[i] = duration_cast<microseconds>(end - start).count();
+  }
+  return sum(times, ITERATIONS) / (ITERATIONS*1.0);
+}
+
+// Sorts the first size keys of array (or their int values) with
+// quick_sort (method 0), sort (method 1) or radix_sort (method 2).
+double radix_list_sort(pair<string,int> array[], size_t size, bool strings,
+                       int method)
+{
+  unsigned long times[ITERATIONS];
+  for (size_t i = 0; i < ITERATIONS; ++i) {
+    ArrayList<string> string_list;
+    ArrayList<long> int_list;
+    for (size_t j = 0; j < size; ++j) {
+      if (strings)
+        string_list.add(array[j].first);
+      else
+        int_list.add((long)array[j].second * 2654435761L % 1000000007L);
+    }
+    auto start = high_resolution_clock::now();
+    if (strings) {
+      if (method == 0) string_list.quick_sort();
+      else if (method == 1) string_list.sort();
+      else string_list.radix_sort();
+    }
+    else {
+      if (method == 0) int_list.quick_sort();
+      else if (method == 1) int_list.sort();
+      else int_list.radix_sort();
+    }
+    auto end = high_resolution_clock::now();
+    times[i] = duration_cast<microseconds>(end - start).count();
+  }
+  return sum(times, ITERATIONS) / (ITERATIONS*1.0);
+}
+
+// Runs 10000 range finds of 8 consecutive keys on an RBTCollection of
+// size pairs, each into a newly constructed output list (ArrayList or
+// SmallArrayList), and returns the average time of one query.
+double short_ranges(pair<string,int> array[], size_t size, bool small_list)
+{
+  const size_t QUERIES = 10000;
+  Collection<string,int>* collection = create_collection(RBTSEARCHTREE);
+  for (size_t i = 0; i < size; ++i)
+    collection->add(array[i].first, array[i].second);
+  ArrayList<string> sorted;
+  collection->sort(sorted);
+  unsigned long times[ITERATIONS];
+  for (size_t i = 0; i < ITERATIONS; ++i) {
+    size_t found = 0;
+    auto start = high_resolution_clock::now();
+    for (size_t q = 0; q < QUERIES; ++q) {
+      size_t first = (q * 7919) % (size - 8);
+      string k1, k2;
+      sorted.get(first, k1);
+      sorted.get(first + 7, k2);
+      if (small_list) {
+        SmallArrayList<string,16> keys;
+        collection->find(k1, k2, keys);
+        found += keys.size();
+      }
+      else {
+        ArrayList<string> keys;
+        collection->find(k1, k2, keys);
+        found += keys.size();
+      }
+    }
+    auto end = high_resolution_clock::now();
+    assert(found == 8 * QUERIES);
+    times[i] = duration_cast<nanoseconds>(end - start).count() / QUERIES;
+  }
+  delete collection;
+  return sum(times, ITERATIONS) / (ITERATIONS*1000.0);
+}
+
+// Loads a BinSearchCollection or ArrayListCollection with size pairs
+// and then times adding the next 1000 pairs one at a time or as a
+// single batch.
+double batch_add(pair<string,int> array[], size_t size, int type, bool batched)
+{
+  const size_t BATCH = 1000;
+  unsigned long times[ITERATIONS];
+  for (size_t i = 0; i < ITERATIONS; ++i) {
+    BinSearchCollection<string,int> bin_search;
+    ArrayListCollection<string,int> array_list;
+    if (type == BINSEARCH)
+      bin_search.add(array, size);
+    else
+      array_list.add(array, size);
+    auto start = high_resolution_clock::now();
+    if (batched) {
+      if (type == BINSEARCH)
+        bin_search.add(array + size, BATCH);
+      else
+        array_list.add(array + size, BATCH);
+    }
+    else {
+      for (size_t j = size; j < size + BATCH; ++j) {
+        if (type == BINSEARCH)
+          bin_search.add(array[j].first, array[j].second);
+        else
+          array_list.add(array[j].first, array[j].second);
+      }
+    }
+    auto end = high_resolution_clock::now();
+    times[i] = duration_cast<microseconds>(end - start).count();
+    assert(bin_search.size() + array_list.size() == size + BATCH);
+  }
+  return sum(times, ITERATIONS) / (ITERATIONS*1.0);
+}
+
+// Builds an <int,int> collection of size scattered keys and returns the
+// average time in nanoseconds of a find, half of which miss.
+double int_finds(size_t size, int type)
+{
+  const size_t FINDS = 100000;
+  Collection<int,int>* collection;
+  if (type == ARRAYLIST)
+    collection = new ArrayListCollection<int,int>();
+  else if (type == RBTSEARCHTREE)
+    collection = new RBTCollection<int,int>();
+  else
+    collection = new HashTableCollection<int,int>();
+  for (size_t i = 0; i < size; ++i)
+    collection->add((int)(i * 2654435761u % 1000003) * 2, (int)i);
+  unsigned long times[ITERATIONS];
+  for (size_t i = 0; i < ITERATIONS; ++i) {
+    size_t found = 0;
+    int val;
+    auto start = high_resolution_clock::now();
+    for (size_t f = 0; f < FINDS; ++f) {
+      // even probes hit a stored key, odd ones (odd keys) never do
+      int key = (int)((f/2) % size * 2654435761u % 1000003) * 2 + (int)(f % 2);
+      if (collection->find(key, val))
+        found++;
+    }
+    auto end = high_resolution_clock::now();
+    assert(found == FINDS/2);
+    times[i] = duration_cast<nanoseconds>(end - start).count();
+  }
+  delete collection;
+  return sum(times, ITERATIONS) / (ITERATIONS * 1.0 * FINDS);
+}
+
+// Returns the average time in nanoseconds of a find (of a random
+// stored key) on a collection holding size pairs.
+double lookups(pair<string,int> array[], size_t size, int type)
+{
+  const size_t FINDS = 100000;
+  Collection<string,int>* collection = create_collection(type);
+  if (type == BINSEARCH) // one at a time adds would be quadratic here
+    ((BinSearchCollection<string,int>*)collection)->add(array, size);
+  else
+    for (size_t i = 0; i < size; ++i)
+      collection->add(array[i].first, array[i].second);
+  unsigned long times[ITERATIONS];
+  for (size_t i = 0; i < ITERATIONS; ++i) {
+    unsigned long seed = 88172645463325252UL + i;
+    size_t found = 0;
+    int val;
+    auto start = high_resolution_clock::now();
+    for (size_t f = 0; f < FINDS; ++f) {
+      seed ^= seed << 13;
+      seed ^= seed >> 7;
+      seed ^= seed << 17;
+      if (collection->find(array[seed % size].first, val))
+        found++;
+    }
+    auto end = high_resolution_clock::now();
+    assert(found == FINDS);
+    times[i] = duration_cast<nanoseconds>(end - start).count();
+  }
+  delete collection;
+  return sum(times, ITERATIONS) / (ITERATIONS * 1.0 * FINDS);
+}
+
+// Fills results with the average time in nanoseconds for a
+// BinSearchCollection of size pairs to find its 10 smallest keys, to
+// count the middle 20% of its keys and to find them.
+void range_counts(pair<string,int> array[], size_t size, double results[3])
+{
+  const size_t REPEATS = 100;
+  BinSearchCollection<string,int>* collection = new BinSearchCollection<string,int>();
+  collection->add(array, size);
+  ArrayList<string> sorted; // the shuffled input isn't the first size keys
+  collection->sort(sorted);
+  string first = sorted.data()[0];
+  string tenth = sorted.data()[9];
+  string k1 = sorted.data()[(size/2) - (size/10)];
+  string k2 = sorted.data()[(size/2) + (size/10)];
+  for (int run = 0; run < 3; ++run) {
+    unsigned long times[ITERATIONS];
+    for (size_t i = 0; i < ITERATIONS; ++i) {
+      ArrayList<string> keys;
+      size_t found = 0;
+      auto start = high_resolution_clock::now();
+      for (size_t r = 0; r < REPEATS; ++r) {
+        if (run == 0) {
+          collection->find(first, tenth, keys);
+          found += keys.size();
+        }
+        else if (run == 1)
+          found += collection->count_range(k1, k2);
+        else {
+          collection->find(k1, k2, keys);
+          found += keys.size();
+        }
+      }
+      auto end = high_resolution_clock::now();
+      assert(found > 0);
+      times[i] = duration_cast<nanoseconds>(end - start).count();
+    }
+    results[run] = sum(times, ITERATIONS) / (ITERATIONS * 1.0 * REPEATS);
+  }
+  delete collection;
+}
+
+// Fills results[0..2] with the average time in nanoseconds of a find
+// of a random stored key (out of size) on a HashTableCollection<int,int>,
+// a frozen BinSearchCollection<int,int> and a FrozenHashCollection<int,int>
+// built from the hash table, and results[3] with that build's time in
+// milliseconds.
+void perfect_hash_lookups(size_t size, double results[4])
+{
+  const size_t FINDS = 1000000;
+  HashTableCollection<int,int>* hash_table = new HashTableCollection<int,int>();
+  BinSearchCollection<int,int>* bin_search = new BinSearchCollection<int,int>();
+  pair<int,int>* pairs = new pair<int,int>[size];
+  for (size_t i = 0; i < size; ++i) {
+    pairs[i] = pair<int,int>((int)(i * 2), (int)i);
+    hash_table->add(pairs[i].first, pairs[i].second);
+  }
+  bin_search->add(pairs, size);
+  bin_search->freeze();
+  delete [] pairs;
+  auto start = high_resolution_clock::now();
+  FrozenHashCollection<int,int>* frozen = new FrozenHashCollection<int,int>(*hash_table);
+  auto end = high_resolution_clock::now();
+  assert(frozen->size() == size);
+  results[3] = duration_cast<microseconds>(end - start).count() / 1000.0;
+  for (int run = 0; run < 3; ++run) {
+    Collection<int,int>* collection = hash_table;
+    if (run == 1)
+      collection = bin_search;
+    else if (run == 2)
+      collection = frozen;
+    unsigned long times[ITERATIONS];
+    for (size_t i = 0; i < ITERATIONS; ++i) {
+      unsigned long seed = 88172645463325252UL + i;
+      size_t found = 0;
+      int val;
+      start = high_resolution_clock::now();
+      for (size_t f = 0; f < FINDS; ++f) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        if (collection->find((int)(seed % size) * 2, val))
+          found++;
+      }
+      end = high_resolution_clock::now();
+      assert(found == FINDS);
+      times[i] = duration_cast<nanoseconds>(end - start).count();
+    }
+    results[run] = sum(times, ITERATIONS) / (ITERATIONS * 1.0 * FINDS);
+  }
+  delete hash_table;
+  delete bin_search;
+  delete frozen;
+}
+
+// Returns the key with the given rank: nearly uniform keys are i*16
+// plus a little noise, skewed keys are i*i
+long learned_key(size_t i, bool skewed)
+{
+  if (skewed)
+    return (long)i * (long)i;
+  return (long)i * 16 + (long)((i * 2654435761UL) % 8);
+}
+
+// Fills results with the average time in nanoseconds per find in a
+// BinSearchCollection of size integer keys using binary search and
+// using a learned index, for nearly uniform keys (results[0] and [1])
+// and skewed keys ([2] and [3]), followed by the number of segments in
+// each model ([4] and [5]).
+void learned_lookups(size_t size, double results[6])
+{
+  const size_t FINDS = 1000000;
+  for (int skewed = 0; skewed < 2; ++skewed) {
+    BinSearchCollection<long,int>* bin_search = new BinSearchCollection<long,int>();
+    pair<long,int>* pairs = new pair<long,int>[size];
+    for (size_t i = 0; i < size; ++i)
+      pairs[i] = pair<long,int>(learned_key(i, skewed), (int)i);
+    bin_search->add(pairs, size);
+    delete [] pairs;
+    BinSearchCollection<long,int>* learned = new BinSearchCollection<long,int>(*bin_search);
+    learned->learn();
+    results[4 + skewed] = learned->learned_segments();
+    for (int run = 0; run < 2; ++run) {
+      Collection<long,int>* collection = run == 0 ? bin_search : learned;
+      unsigned long times[ITERATIONS];
+      for (size_t i = 0; i < ITERATIONS; ++i) {
+        unsigned long seed = 88172645463325252UL + i;
+        size_t found = 0;
+        int val;
+        auto start = high_resolution_clock::now();
+        for (size_t f = 0; f < FINDS; ++f) {
+          seed ^= seed << 13;
+          seed ^= seed >> 7;
+          seed ^= seed << 17;
+          if (collection->find(learned_key(seed % size, skewed), val))
+            found++;
+        }
+        auto end = high_resolution_clock::now();
+        assert(found == FINDS);
+        times[i] = duration_cast<nanoseconds>(end - start).count();
+      }
+      results[2*skewed + run] = sum(times, ITERATIONS) / (ITERATIONS * 1.0 * FINDS);
+    }
+    delete bin_search;
+    delete learned;
+  }
+}
+
+// Returns the bytes currently allocated on the heap
+size_t heap_bytes()
+{
+  struct mallinfo2 info = mallinfo2();
+  return info.uordblks + info.hblkhd;
+}
 
+// Returns the heap bytes per node for size nodes in the old AVL node
+// layout, holding the same keys and values a tree would
+template<typename K, typename V>
+double legacy_avl_bytes(const K keys[], size_t size)
+{
+  size_t before = heap_bytes();
+  LegacyAVLNode<K,V>* nodes = nullptr;
+  for (size_t i = 0; i < size; ++i) { // chained through left so none leak
+    LegacyAVLNode<K,V>* node = new LegacyAVLNode<K,V>();
+    node->key = keys[i];
+    node->height = 1;
+    node->left = nodes;
+    node->right = nullptr;
+    nodes = node;
+  }
+  double bytes = (heap_bytes() - before) / (1.0 * size);
+  while (nodes) {
+    LegacyAVLNode<K,V>* next = nodes->left;
+    delete nodes;
+    nodes = next;
+  }
+  return bytes;
+}
+
+// Fills results with the heap bytes per pair of an AVLCollection with
+// size int keys ([0]) and string keys ([2]), and of the old node layout
+// holding the same keys ([1] and [3]).
+void avl_memory(pair<string,int> array[], size_t size, double results[4])
+{
+  int* int_keys = new int[size];
+  string* string_keys = new string[size];
+  for (size_t i = 0; i < size; ++i) {
+    int_keys[i] = (int)((i * 7919) % size);
+    string_keys[i] = array[i].first;
+  }
+  size_t before = heap_bytes();
+  AVLCollection<int,int>* int_tree = new AVLCollection<int,int>();
+  for (size_t i = 0; i < size; ++i)
+    int_tree->add(int_keys[i], (int)i);
+  results[0] = (heap_bytes() - before) / (1.0 * size);
+  delete int_tree;
+  results[1] = legacy_avl_bytes<int,int>(int_keys, size);
+  before = heap_bytes();
+  AVLCollection<string,int>* string_tree = new AVLCollection<string,int>();
+  for (size_t i = 0; i < size; ++i)
+    string_tree->add(string_keys[i], (int)i);
+  results[2] = (heap_bytes() - before) / (1.0 * size);
+  delete string_tree;
+  results[3] = legacy_avl_bytes<string,int>(string_keys, size);
+  delete [] int_keys;
+  delete [] string_keys;
+}
+
+// Returns the average time in nanoseconds per add, find or remove for
+// a collection of the given type that is created, given size integer
+// keys, searched for each one and then emptied, over and over.
+double small_maps(size_t size, int type)
+{
+  const size_t OPS = 3000000;
+  size_t maps = OPS / (3 * size);
+  unsigned long times[ITERATIONS];
+  for (size_t i = 0; i < ITERATIONS; ++i) {
+    size_t found = 0;
+    auto start = high_resolution_clock::now();
+    for (size_t m = 0; m < maps; ++m) {
+      Collection<int,int>* collection;
+      if (type == ADAPTIVE)
+        collection = new AdaptiveCollection<int,int>();
+      else if (type == RBTSEARCHTREE)
+        collection = new RBTCollection<int,int>();
+      else
+        collection = new HashTableCollection<int,int>();
+      for (size_t k = 0; k < size; ++k)
+        collection->add((int)((k * 7919) % size), (int)k);
+      int val;
+      for (size_t k = 0; k < size; ++k)
+        if (collection->find((int)k, val))
+          found++;
+      for (size_t k = 0; k < size; ++k)
+        collection->remove((int)k);
+      delete collection;
+    }
+    auto end = high_resolution_clock::now();
+    assert(found == maps * size);
+    times[i] = duration_cast<nanoseconds>(end - start).count();
+  }
+  return sum(times, ITERATIONS) / (ITERATIONS * 3.0 * maps * size);
+}
+
+// Fills results with the average time in nanoseconds of a find of a
+// random stored key (out of size) by binary search over an array of
+// pair<int,LargeValue>, on a BinSearchCollection<int,LargeValue> and on
+// a BinSearchCollection<int,int>.
+void large_value_lookups(size_t size, double results[3])
+{
+  const size_t FINDS = 1000000;
+  pair<int,LargeValue>* pairs = new pair<int,LargeValue>[size];
+  pair<int,int>* small_pairs = new pair<int,int>[size];
+  for (size_t i = 0; i < size; ++i) {
+    pairs[i].first = (int)(i * 2);
+    pairs[i].second.bytes[0] = (char)i;
+    small_pairs[i] = pair<int,int>((int)(i * 2), (int)i);
+  }
+  BinSearchCollection<int,LargeValue>* large = new BinSearchCollection<int,LargeValue>();
+  BinSearchCollection<int,int>* small = new BinSearchCollection<int,int>();
+  large->add(pairs, size);
+  small->add(small_pairs, size);
+  for (int run = 0; run < 3; ++run) {
+    unsigned long times[ITERATIONS];
+    for (size_t i = 0; i < ITERATIONS; ++i) {
+      unsigned long seed = 88172645463325252UL + i;
+      size_t found = 0;
+      LargeValue large_val;
+      int small_val;
+      auto start = high_resolution_clock::now();
+      for (size_t f = 0; f < FINDS; ++f) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        int key = (int)(seed % size) * 2;
+        if (run == 0) { // BinSearchCollection's search, run over pairs
+          const pair<int,LargeValue>* base = pairs;
+          size_t n = size;
+          while (n > 1) {
+            size_t half = n / 2;
+            size_t next = (n - half) / 2;
+            __builtin_prefetch(base + next);
+            __builtin_prefetch(base + half + next);
+            base = (base[half].first < key) ? base + half : base;
+            n -= half;
+          }
+          base += (base->first < key);
+          if (base < pairs + size && base->first == key) {
+            large_val = base->second;
+            found++;
+          }
+        }
+        else if (run == 1 && large->find(key, large_val))
+          found++;
+        else if (run == 2 && small->find(key, small_val))
+          found++;
+      }
+      auto end = high_resolution_clock::now();
+      assert(found == FINDS);
+      times[i] = duration_cast<nanoseconds>(end - start).count();
+    }
+    results[run] = sum(times, ITERATIONS) / (ITERATIONS * 1.0 * FINDS);
+  }
+  delete [] pairs;
+  delete [] small_pairs;
+  delete large;
+  delete small;
+}
+
+// Fills results with the average time in nanoseconds of a find of a
+// random stored key on a BinSearchCollection<int,int> of size keys
+// before and after freeze(), and on an RBTCollection<int,int>.
+void frozen_lookups(size_t size, double results[3])
+{
+  const size_t FINDS = 1000000;
+  BinSearchCollection<int,int>* bin_search = new BinSearchCollection<int,int>();
+  RBTCollection<int,int>* rbt = new RBTCollection<int,int>();
+  pair<int,int>* pairs = new pair<int,int>[size];
+  for (size_t i = 0; i < size; ++i) {
+    pairs[i] = pair<int,int>((int)(i * 2), (int)i);
+    rbt->add(pairs[i].first, pairs[i].second);
+  }
+  bin_search->add(pairs, size);
+  delete [] pairs;
+  for (int run = 0; run < 3; ++run) {
+    Collection<int,int>* collection = bin_search;
+    if (run == 1)
+      bin_search->freeze();
+    else if (run == 2)
+      collection = rbt;
+    unsigned long times[ITERATIONS];
+    for (size_t i = 0; i < ITERATIONS; ++i) {
+      unsigned long seed = 88172645463325252UL + i;
+      size_t found = 0;
+      int val;
+      auto start = high_resolution_clock::now();
+      for (size_t f = 0; f < FINDS; ++f) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        if (collection->find((int)(seed % size) * 2, val))
+          found++;
+      }
+      auto end = high_resolution_clock::now();
+      assert(found == FINDS);
+      times[i] = duration_cast<nanoseconds>(end - start).count();
+    }
+    results[run] = sum(times, ITERATIONS) / (ITERATIONS * 1.0 * FINDS);
+  }
+  delete bin_search;
+  delete rbt;
+}
+
+// Fills results with the average time in microseconds to add size
+// random integer keys one at a time to a BinSearchCollection<int,int>,
+// to one with its insert buffer on, and to an RBTCollection<int,int>.
+void build_times(size_t size, double results[3])
+{
+  for (int run = 0; run < 3; ++run) {
+    unsigned long times[ITERATIONS];
+    for (size_t i = 0; i < ITERATIONS; ++i) {
+      BinSearchCollection<int,int>* bin_search = new BinSearchCollection<int,int>();
+      RBTCollection<int,int>* rbt = new RBTCollection<int,int>();
+      Collection<int,int>* collection = bin_search;
+      if (run == 1)
+        bin_search->set_insert_buffer(true);
+      else if (run == 2)
+        collection = rbt;
+      unsigned long seed = 88172645463325252UL + i;
+      auto start = high_resolution_clock::now();
+      for (size_t k = 0; k < size; ++k) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        collection->add((int)(seed % 1000000000), (int)k);
+      }
+      auto end = high_resolution_clock::now();
+      assert(collection->size() == size);
+      times[i] = duration_cast<microseconds>(end - start).count();
+      delete bin_search;
+      delete rbt;
+    }
+    results[run] = sum(times, ITERATIONS) / (ITERATIONS * 1.0);
+  }
+}
+
+// Fills results[0..2] with the average time in microseconds to add
+// size random integer keys one at a time to a BinSearchCollection with
+// its insert buffer on, a PMACollection and an RBTCollection, and
+// results[3..5] with the time for each to return every key in order
+// through a range find.
+void pma_times(size_t size, double results[6])
+{
+  for (int run = 0; run < 3; ++run) {
+    unsigned long add_times[ITERATIONS];
+    unsigned long scan_times[ITERATIONS];
+    for (size_t i = 0; i < ITERATIONS; ++i) {
+      Collection<int,int>* collection = nullptr;
+      if (run == 0) {
+        BinSearchCollection<int,int>* bin_search = new BinSearchCollection<int,int>();
+        bin_search->set_insert_buffer(true);
+        collection = bin_search;
+      }
+      else if (run == 1)
+        collection = new PMACollection<int,int>();
+      else
+        collection = new RBTCollection<int,int>();
+      unsigned long seed = 88172645463325252UL + i;
+      auto start = high_resolution_clock::now();
+      for (size_t k = 0; k < size; ++k) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        collection->add((int)(seed % 1000000000), (int)k);
+      }
+      auto end = high_resolution_clock::now();
+      add_times[i] = duration_cast<microseconds>(end - start).count();
+      ArrayList<int> keys;
+      start = high_resolution_clock::now();
+      collection->find(0, 1000000000, keys);
+      end = high_resolution_clock::now();
+      assert(keys.size() == collection->size());
+      scan_times[i] = duration_cast<microseconds>(end - start).count();
+      delete collection;
+    }
+    results[run] = sum(add_times, ITERATIONS) / (ITERATIONS * 1.0);
+    results[run + 3] = sum(scan_times, ITERATIONS) / (ITERATIONS * 1.0);
+  }
+}
+
+// Runs read_percent% finds and the rest alternating add/remove on a
+// collection pre-loaded with size pairs from 1 to threads worker
+// threads. Each thread only adds and removes its own keys (taken from
+// past the pre-loaded ones) so keys are never added twice. A plain
+// HashTableCollection is guarded by a single global mutex.
+double mixed_ops(pair<string,int> array[], size_t size, size_t threads,
+                 int read_percent, int type)
+{
+  Collection<string,int>* collection = create_collection(type);
+  for (size_t i = 0; i < size; ++i)
+    collection->add(array[i].first, array[i].second);
+  mutex global_lock;
+  bool use_lock = (type == HASHTABLE);
+  size_t own_keys = size / threads;
+  auto worker = [&](size_t id) {
+    unsigned long seed = 88172645463325252UL + id;
+    size_t next_own = 0;
+    bool added = false;
+    for (size_t op = 0; op < THREAD_OPS; ++op) {
+      seed ^= seed << 13;  // xorshift: cheap and per thread
+      seed ^= seed >> 7;
+      seed ^= seed << 17;
+      int val;
+      if ((int)(seed % 100) < read_percent) {
+        const string& key = array[(seed >> 8) % size].first;
+        if (use_lock) {
+          lock_guard<mutex> guard(global_lock);
+          collection->find(key, val);
+        }
+        else
+          collection->find(key, val);
+      }
+      else {
+        const pair<string,int>& p = array[size + id + next_own*threads];
+        if (use_lock) {
+          lock_guard<mutex> guard(global_lock);
+          if (added) collection->remove(p.first);
+          else collection->add(p.first, p.second);
+        }
+        else if (added)
+          collection->remove(p.first);
+        else
+          collection->add(p.first, p.second);
+        if (added)
+          next_own = (next_own + 1) % own_keys;
+        added = !added;
+      }
+    }
+  };
+  auto start = high_resolution_clock::now();
+  thread* workers = new thread[threads];
+  for (size_t t = 0; t < threads; ++t)
+    workers[t] = thread(worker, t);
+  for (size_t t = 0; t < threads; ++t)
+    workers[t].join();
+  auto end = high_resolution_clock::now();
+  delete [] workers;
+  delete collection;
+  double secs = duration_cast<microseconds>(end - start).count() / 1000000.0;
+  return (threads * THREAD_OPS) / secs;
+}
@@ -3,6 +3,7 @@
 // File: hw9_test.cpp
 // Date: Fall 2020
 // Desc: Unit tests for the red-black tree collection implementation
+//       and the other collection implementations
 //----------------------------------------------------------------------
 
 
@@ -11,6 +12,18 @@
 #include <gtest/gtest.h>
 #include "array_list.h"
 #include "rbt_collection.h"
+#include "avl_collection.h"
+#include "array_list_collection.h"
+#include "bin_search_collection.h"
+#include "hash_table_collection.h"
+#include "small_array_list.h"
+#include "concurrent_hash_table_collection.h"
+#include "split_ordered_hash_collection.h"
+#include "pma_collection.h"
+#include "adaptive_collection.h"
+#include "frozen_hash_collection.h"
+#include <thread>
+#include <memory>
 
 
 using namespace std;
@@ -547,6 +560,1155 @@ TEST(RBTCollectionTest, TESTyd) {
   ASSERT_EQ(true, c.valid_rbt());
 }
 
+// ArrayList: moves leave the source empty but usable, clear keeps
+// the capacity, reserve and shrink_to_fit keep the items
+TEST(ArrayListTest, MoveClearReserve) {
+  ArrayList<string> a;
+  for (int i = 0; i < 25; ++i)
+    a.add(to_string(i));
+  ArrayList<string> b(std::move(a));
+  ASSERT_EQ(0, a.size());
+  ASSERT_EQ(25, b.size());
+  a.add("x");
+  ASSERT_EQ(1, a.size());
+  a = std::move(b);
+  ASSERT_EQ(25, a.size());
+  ASSERT_EQ(0, b.size());
+  string s;
+  ASSERT_EQ(true, a.get(24, s));
+  ASSERT_EQ("24", s);
+  a.clear();
+  ASSERT_EQ(0, a.size());
+  ASSERT_EQ(false, a.get(0, s));
+  a.reserve(100);
+  for (int i = 0; i < 5; ++i)
+    a.add(to_string(i));
+  a.shrink_to_fit();
+  ASSERT_EQ(5, a.size());
+  ASSERT_EQ(true, a.get(4, s));
+  ASSERT_EQ("4", s);
+  a.add("5");
+  ASSERT_EQ(6, a.size());
+  ArrayList<string> c;
+  c = a;
+  c = a;
+  ASSERT_EQ(6, c.size());
+}
+
+// ArrayList: sort handles sorted, reversed, duplicate-heavy and
+// random input, including sizes that fall back to heapsort paths
+TEST(ArrayListTest, SortInputShapes) {
+  const int n = 5000;
+  for (int shape = 0; shape < 5; ++shape) {
+    ArrayList<int> a;
+    unsigned int seed = 12345;
+    for (int i = 0; i < n; ++i) {
+      seed = seed * 1103515245 + 12345;
+      if (shape == 0) a.add(i);
+      else if (shape == 1) a.add(n - i);
+      else if (shape == 2) a.add(seed % 7);
+      else if (shape == 3) a.add(seed % 100000);
+      else a.add(i % 2 ? i : n - i); // organ pipe-ish
+    }
+    a.sort();
+    ASSERT_EQ(n, a.size());
+    int prev, cur;
+    a.get(0, prev);
+    for (int i = 1; i < n; ++i) {
+      a.get(i, cur);
+      ASSERT_LE(prev, cur);
+      prev = cur;
+    }
+  }
+}
+
+// ArrayList: sort keeps every item (none lost or duplicated)
+TEST(ArrayListTest, SortKeepsItems) {
+  ArrayList<string> a;
+  for (int i = 99; i >= 0; --i)
+    a.add(to_string(i % 10) + to_string(i));
+  a.add("5");
+  a.sort();
+  ASSERT_EQ(101, a.size());
+  string s;
+  a.get(0, s);
+  ASSERT_EQ("00", s);
+  a.get(100, s);
+  ASSERT_EQ("999", s);
+  int count = 0;
+  for (size_t i = 0; i < a.size(); ++i) {
+    a.get(i, s);
+    if (s == "5") count++;
+  }
+  ASSERT_EQ(1, count);
+}
+
+// ArrayList: parallel_sort gives the same result for any thread
+// count, and sort() switches to it on large lists
+TEST(ArrayListTest, ParallelSort) {
+  const int n = 200000;
+  for (size_t threads = 1; threads <= 8; threads *= 2) {
+    ArrayList<int> a;
+    unsigned int seed = 777;
+    for (int i = 0; i < n; ++i) {
+      seed = seed * 1103515245 + 12345;
+      a.add((seed >> 4) % 50000);
+    }
+    if (threads == 8)
+      a.sort();
+    else
+      a.parallel_sort(threads);
+    ASSERT_EQ(n, a.size());
+    int prev, cur;
+    a.get(0, prev);
+    for (int i = 1; i < n; ++i) {
+      a.get(i, cur);
+      ASSERT_LE(prev, cur);
+      prev = cur;
+    }
+    a.add(-1); // still usable after the buffers were swapped
+    a.get(n, cur);
+    ASSERT_EQ(-1, cur);
+  }
+  ArrayList<string> s;
+  s.add("b");
+  s.add("a");
+  s.parallel_sort(4); // too small to split, sorted in place
+  string v;
+  s.get(0, v);
+  ASSERT_EQ("a", v);
+}
+
+// ArrayList: radix_sort orders negative and positive integers,
+// strings (including prefixes and empties) and falls back otherwise
+TEST(ArrayListTest, RadixSort) {
+  ArrayList<long> a;
+  unsigned long seed = 99;
+  for (int i = 0; i < 5000; ++i) {
+    seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+    a.add((long)(seed >> 20) - (1L << 42));
+  }
+  a.add(0);
+  a.add(-1);
+  a.radix_sort();
+  long prev, cur;
+  a.get(0, prev);
+  for (size_t i = 1; i < a.size(); ++i) {
+    a.get(i, cur);
+    ASSERT_LE(prev, cur);
+    prev = cur;
+  }
+  ArrayList<string> s;
+  for (int i = 0; i < 3000; ++i)
+    s.add(to_string((i * 7919) % 1000));
+  s.add("");
+  s.add("1");
+  s.add("10");
+  s.radix_sort();
+  ASSERT_EQ(3003, s.size());
+  string sprev, scur;
+  s.get(0, sprev);
+  ASSERT_EQ("", sprev);
+  for (size_t i = 1; i < s.size(); ++i) {
+    s.get(i, scur);
+    ASSERT_LE(sprev, scur);
+    sprev = scur;
+  }
+  ArrayList<double> d;
+  for (int i = 100; i > 0; --i)
+    d.add(i / 3.0);
+  d.radix_sort();
+  double dfirst;
+  d.get(0, dfirst);
+  ASSERT_DOUBLE_EQ(1 / 3.0, dfirst);
+}
+
+// ArrayList: merge_sort keeps equal keys in their original order,
+// including across galloping merges of long ordered stretches
+struct SortRecord {
+  int key;
+  int order;
+  bool operator<(const SortRecord& rhs) const { return key < rhs.key; }
+};
+
+TEST(ArrayListTest, StableMergeSort) {
+  ArrayList<SortRecord> a;
+  unsigned int seed = 4242;
+  for (int i = 0; i < 3000; ++i) {
+    seed = seed * 1103515245 + 12345;
+    SortRecord r;
+    r.key = (i < 1000) ? i / 3 : (int)((seed >> 8) % 50); // a sorted stretch
+    r.order = i;
+    a.add(r);
+  }
+  a.merge_sort();
+  ASSERT_EQ(3000, a.size());
+  SortRecord prev, cur;
+  a.get(0, prev);
+  for (size_t i = 1; i < a.size(); ++i) {
+    a.get(i, cur);
+    ASSERT_LE(prev.key, cur.key);
+    if (prev.key == cur.key) {
+      ASSERT_LT(prev.order, cur.order);
+    }
+    prev = cur;
+  }
+  ArrayList<int> b;
+  for (int i = 0; i < 100; ++i)
+    b.add(i < 50 ? 2*i + 1 : 2*(i-50)); // two interleaving runs
+  b.merge_sort();
+  int x;
+  for (int i = 0; i < 100; ++i) {
+    b.get(i, x);
+    ASSERT_EQ(i, x);
+  }
+}
+
+// ArrayList: unused slots are never constructed, and every item that
+// is constructed is destroyed exactly once through adds, inserts,
+// removes, growth, copies and clear
+struct CountedItem {
+  static int alive;
+  int val;
+  CountedItem(int v = 0) : val(v) { alive++; }
+  CountedItem(const CountedItem& rhs) : val(rhs.val) { alive++; }
+  ~CountedItem() { alive--; }
+  CountedItem& operator=(const CountedItem& rhs) { val = rhs.val; return *this; }
+  bool operator<(const CountedItem& rhs) const { return val < rhs.val; }
+};
+int CountedItem::alive = 0;
+
+TEST(ArrayListTest, StorageLifetimes) {
+  {
+    ArrayList<CountedItem> a;
+    ASSERT_EQ(0, CountedItem::alive);
+    for (int i = 0; i < 40; ++i)
+      a.add(CountedItem(i));
+    ASSERT_EQ(40, CountedItem::alive);
+    a.add(0, CountedItem(-1));
+    a.remove(20);
+    ASSERT_EQ(40, CountedItem::alive);
+    ArrayList<CountedItem> b(a);
+    ASSERT_EQ(80, CountedItem::alive);
+    b.merge_sort();
+    b.sort();
+    b.clear();
+    ASSERT_EQ(40, CountedItem::alive);
+    CountedItem first;
+    a.get(0, first);
+    ASSERT_EQ(-1, first.val);
+  }
+  ASSERT_EQ(0, CountedItem::alive);
+  ArrayList<int> n;
+  for (int i = 0; i < 10; ++i)
+    n.add(i);
+  n.add(3, 100); // shifts the tail up through the memmove path
+  n.remove(0);
+  int x;
+  n.get(2, x);
+  ASSERT_EQ(100, x);
+  n.get(9, x);
+  ASSERT_EQ(9, x);
+  ASSERT_EQ(10, n.size());
+}
+
+// SmallArrayList: stays inline up to N items, spills to the heap past
+// it, moves and copies between inline and heap storage
+TEST(SmallArrayListTest, InlineThenSpill) {
+  SmallArrayList<string,4> a;
+  ASSERT_EQ(true, a.is_inline());
+  for (int i = 0; i < 4; ++i)
+    a.add(to_string(i));
+  ASSERT_EQ(true, a.is_inline());
+  a.add("4");
+  ASSERT_EQ(false, a.is_inline());
+  ASSERT_EQ(5, a.size());
+  a.remove(4);
+  a.shrink_to_fit(); // fits again, so back inline
+  ASSERT_EQ(true, a.is_inline());
+  SmallArrayList<string,4> b(std::move(a));
+  ASSERT_EQ(true, b.is_inline());
+  ASSERT_EQ(4, b.size());
+  ASSERT_EQ(0, a.size());
+  string s;
+  ASSERT_EQ(true, b.get(3, s));
+  ASSERT_EQ("3", s);
+  ArrayList<string> big;
+  for (int i = 0; i < 10; ++i)
+    big.add(to_string(i));
+  b = std::move(big); // steals the heap array
+  ASSERT_EQ(false, b.is_inline());
+  ASSERT_EQ(10, b.size());
+  ArrayList<string> plain(std::move(a)); // empty inline source
+  ASSERT_EQ(0, plain.size());
+  plain = std::move(b);
+  ASSERT_EQ(10, plain.size());
+  SmallArrayList<string,4> c(plain);
+  ASSERT_EQ(10, c.size());
+  c.sort();
+  ASSERT_EQ(true, c.get(9, s));
+  ASSERT_EQ("9", s);
+}
+
+// SmallArrayList: works as the output list of collection queries
+TEST(SmallArrayListTest, CollectionOutput) {
+  RBTCollection<int,int> c;
+  for (int i = 0; i < 100; ++i)
+    c.add(i, i*10);
+  SmallArrayList<int,16> out;
+  c.find(10, 19, out);
+  ASSERT_EQ(10, out.size());
+  ASSERT_EQ(true, out.is_inline());
+  c.sort(out);
+  ASSERT_EQ(100, out.size());
+  int k;
+  out.get(99, k);
+  ASSERT_EQ(99, k);
+  c.find(50, 52, out);
+  ASSERT_EQ(3, out.size());
+}
+
+// ArrayList: append, insert and erase whole ranges, including from
+// the list's own items
+TEST(ArrayListTest, BulkAppendInsertErase) {
+  ArrayList<string> a;
+  string src[] = {"a", "b", "c", "d", "e"};
+  a.append(src, 5);
+  ASSERT_EQ(5, a.size());
+  ASSERT_EQ(true, a.insert(2, src, 3)); // a b a b c c d e
+  ASSERT_EQ(false, a.insert(9, src, 1));
+  ASSERT_EQ(true, a.insert(a.size(), src + 4, 1)); // appends e
+  ASSERT_EQ(9, a.size());
+  string s;
+  a.get(2, s);
+  ASSERT_EQ("a", s);
+  a.get(5, s);
+  ASSERT_EQ("c", s);
+  ASSERT_EQ(true, a.erase(1, 4)); // a c c d e e
+  ASSERT_EQ(false, a.erase(4, 20));
+  ASSERT_EQ(6, a.size());
+  a.get(1, s);
+  ASSERT_EQ("c", s);
+  a.insert(0, a.data() + 3, 3); // d e e a c c d e e
+  ASSERT_EQ(9, a.size());
+  a.get(0, s);
+  ASSERT_EQ("d", s);
+  a.append(a.data(), a.size()); // grows while copying from itself
+  ASSERT_EQ(18, a.size());
+  a.get(17, s);
+  ASSERT_EQ("e", s);
+  ArrayList<int> n;
+  int nums[] = {1, 2, 3, 4};
+  n.append(nums, 4);
+  n.insert(1, nums, 4);
+  n.erase(0, 2);
+  int x;
+  n.get(0, x);
+  ASSERT_EQ(2, x);
+  ASSERT_EQ(6, n.size());
+}
+
+// BinSearchCollection and ArrayListCollection: a batch add is the same
+// as adding the pairs one at a time
+TEST(BinSearchCollectionTest, BulkAdd) {
+  BinSearchCollection<int,int> c;
+  c.add(10, 100);
+  c.add(30, 300);
+  pair<int,int> batch[] = {{40, 4}, {5, 0}, {20, 2}, {35, 3}};
+  c.add(batch, 4);
+  ASSERT_EQ(6, c.size());
+  ArrayList<int> keys;
+  c.sort(keys);
+  int expect[] = {5, 10, 20, 30, 35, 40};
+  int k;
+  for (int i = 0; i < 6; ++i) {
+    keys.get(i, k);
+    ASSERT_EQ(expect[i], k);
+  }
+  int v;
+  ASSERT_EQ(true, c.find(35, v));
+  ASSERT_EQ(3, v);
+  ASSERT_EQ(true, c.find(10, v));
+  ASSERT_EQ(100, v);
+  ArrayListCollection<int,int> a;
+  a.add(batch, 4);
+  ASSERT_EQ(4, a.size());
+  ASSERT_EQ(true, a.find(20, v));
+  ASSERT_EQ(2, v);
+}
+
+// ArrayListCollection: key scans find every position (SIMD blocks and
+// the scalar tail) for 32 bit, 64 bit and non-integer keys
+TEST(ArrayListCollectionTest, FindEveryPosition) {
+  ArrayListCollection<int,int> c32;
+  ArrayListCollection<long,int> c64;
+  ArrayListCollection<string,int> cs;
+  for (int i = 0; i < 53; ++i) {
+    c32.add(-i * 3, i);
+    c64.add((long)i << 33, i);
+    cs.add(to_string(i), i);
+  }
+  int v;
+  for (int i = 0; i < 53; ++i) {
+    ASSERT_EQ(true, c32.find(-i * 3, v));
+    ASSERT_EQ(i, v);
+    ASSERT_EQ(true, c64.find((long)i << 33, v));
+    ASSERT_EQ(i, v);
+    ASSERT_EQ(true, cs.find(to_string(i), v));
+    ASSERT_EQ(i, v);
+  }
+  ASSERT_EQ(false, c32.find(1, v));
+  ASSERT_EQ(false, c64.find(1, v)); // low half matches key 0, high does not
+  ASSERT_EQ(false, c64.find((long)1 << 32, v));
+  c32.remove(-30);
+  c64.remove((long)10 << 33);
+  ASSERT_EQ(52, c32.size());
+  ASSERT_EQ(false, c32.find(-30, v));
+  ASSERT_EQ(true, c32.find(-33, v));
+  ASSERT_EQ(11, v);
+  ASSERT_EQ(false, c64.find((long)10 << 33, v));
+  ArrayList<int> keys;
+  c32.find(-9, 0, keys);
+  ASSERT_EQ(4, keys.size());
+  c32.sort(keys);
+  ASSERT_EQ(52, keys.size());
+  keys.get(0, v);
+  ASSERT_EQ(-156, v);
+}
+
+// BinSearchCollection: lower_bound based add, find, remove and range
+// find agree with the sorted order at both ends and in between
+TEST(BinSearchCollectionTest, AddFindRemoveRange) {
+  BinSearchCollection<int,int> c;
+  for (int i = 0; i < 200; ++i)
+    c.add((i * 37) % 200 * 2, i); // even keys 0..398 in scattered order
+  ASSERT_EQ(200, c.size());
+  int v;
+  for (int k = -1; k <= 400; ++k)
+    ASSERT_EQ(k >= 0 && k < 400 && k % 2 == 0, c.find(k, v));
+  ArrayList<int> keys;
+  c.find(-5, 7, keys);
+  ASSERT_EQ(4, keys.size());
+  c.find(391, 1000, keys);
+  ASSERT_EQ(4, keys.size());
+  c.find(11, 11, keys);
+  ASSERT_EQ(0, keys.size());
+  c.remove(0);
+  c.remove(398);
+  c.remove(5); // not there
+  ASSERT_EQ(198, c.size());
+  ASSERT_EQ(false, c.find(0, v));
+  ASSERT_EQ(true, c.find(2, v));
+  c.sort(keys);
+  int prev, cur;
+  keys.get(0, prev);
+  ASSERT_EQ(2, prev);
+  for (size_t i = 1; i < keys.size(); ++i) {
+    keys.get(i, cur);
+    ASSERT_LT(prev, cur);
+    prev = cur;
+  }
+}
+
+// BinSearchCollection: a frozen collection finds the same keys, for
+// sizes that fill the last Eytzinger level partly and completely, and
+// thaws on the next update
+TEST(BinSearchCollectionTest, FreezeAndThaw) {
+  for (int n = 0; n <= 33; ++n) {
+    BinSearchCollection<int,int> c;
+    for (int i = 0; i < n; ++i)
+      c.add(i * 3, i);
+    c.freeze();
+    ASSERT_EQ(true, c.is_frozen());
+    int v;
+    for (int k = -2; k <= 3 * n + 2; ++k) {
+      bool stored = k >= 0 && k % 3 == 0 && k < 3 * n;
+      ASSERT_EQ(stored, c.find(k, v));
+      if (stored) {
+        ASSERT_EQ(k / 3, v);
+      }
+    }
+  }
+  BinSearchCollection<string,int> s;
+  s.add("b", 2);
+  s.add("a", 1);
+  s.freeze();
+  int v;
+  ASSERT_EQ(true, s.find("b", v));
+  ASSERT_EQ(2, v);
+  ArrayList<string> keys;
+  s.find("a", "z", keys); // scans still use the sorted pairs
+  ASSERT_EQ(2, keys.size());
+  s.add("c", 3);
+  ASSERT_EQ(false, s.is_frozen());
+  ASSERT_EQ(true, s.find("c", v));
+  s.freeze();
+  s.remove("a");
+  ASSERT_EQ(false, s.is_frozen());
+  ASSERT_EQ(false, s.find("a", v));
+}
+
+TEST(BinSearchCollectionTest, InsertBuffer) {
+  BinSearchCollection<int,int> c;
+  c.set_insert_buffer(true);
+  ASSERT_EQ(true, c.has_insert_buffer());
+  for (int i = 0; i < 1000; ++i)
+    c.add((i * 389) % 1000, i); // every key 0..999, merged in several rounds
+  ASSERT_EQ(1000, c.size());
+  int v;
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_EQ(true, c.find((i * 389) % 1000, v));
+    ASSERT_EQ(i, v);
+  }
+  ASSERT_EQ(false, c.find(1000, v));
+  c.remove(999); // wherever it lives now
+  c.add(1001, 1);
+  c.remove(1001); // still buffered
+  ASSERT_EQ(false, c.find(999, v));
+  ASSERT_EQ(false, c.find(1001, v));
+  ASSERT_EQ(999, c.size());
+  ArrayList<int> keys;
+  c.find(100, 199, keys);
+  ASSERT_EQ(100, keys.size());
+  for (int i = 0; i < 100; ++i)
+    ASSERT_EQ(100 + i, keys.data()[i]);
+  c.sort(keys);
+  ASSERT_EQ(999, keys.size());
+  for (int i = 0; i < 999; ++i)
+    ASSERT_EQ(i, keys.data()[i]);
+  c.keys(keys);
+  ASSERT_EQ(999, keys.size());
+  BinSearchCollection<int,int> copy = c; // the buffer is copied too
+  c.freeze(); // merges the buffer first
+  ASSERT_EQ(999, c.size());
+  ASSERT_EQ(true, c.find(500, v));
+  ASSERT_EQ(true, copy.find(998, v));
+  c.add(2000, 2);
+  c.set_insert_buffer(false);
+  ASSERT_EQ(false, c.has_insert_buffer());
+  ASSERT_EQ(true, c.find(2000, v));
+  ASSERT_EQ(2, v);
+}
+
+TEST(BinSearchCollectionTest, CountRange) {
+  BinSearchCollection<int,int> c;
+  ASSERT_EQ(0, c.count_range(0, 10));
+  for (int i = 0; i < 100; ++i)
+    c.add(i * 2, i); // even keys 0..198
+  ASSERT_EQ(100, c.count_range(0, 198));
+  ASSERT_EQ(100, c.count_range(-5, 500));
+  ASSERT_EQ(6, c.count_range(10, 20)); // both ends stored
+  ASSERT_EQ(5, c.count_range(11, 21)); // neither end stored
+  ASSERT_EQ(1, c.count_range(4, 4));
+  ASSERT_EQ(0, c.count_range(5, 5));
+  ASSERT_EQ(0, c.count_range(20, 10));
+  ASSERT_EQ(0, c.count_range(199, 300));
+  ArrayList<int> keys;
+  c.find(11, 21, keys);
+  ASSERT_EQ(5, keys.size());
+  ASSERT_EQ(12, keys.data()[0]);
+  ASSERT_EQ(20, keys.data()[4]);
+  c.set_insert_buffer(true); // buffered keys count too
+  c.add(13, 0);
+  c.add(500, 0);
+  ASSERT_EQ(6, c.count_range(11, 21));
+  ASSERT_EQ(102, c.count_range(-5, 500));
+  c.freeze(); // counts use the sorted pairs either way
+  ASSERT_EQ(6, c.count_range(11, 21));
+}
+
+TEST(BinSearchCollectionTest, LearnedIndex) {
+  BinSearchCollection<long,int> c;
+  int v;
+  ASSERT_EQ(true, c.learn()); // an empty model still works
+  ASSERT_EQ(false, c.find(1, v));
+  for (long i = 0; i < 3000; ++i)
+    c.add(i * i * i, (int)i); // skewed: gaps grow with the key
+  c.add(1L << 62, -1); // too large for a double to hold exactly
+  c.add((1L << 62) + 1, -2);
+  ASSERT_EQ(false, c.is_learned());
+  ASSERT_EQ(true, c.learn());
+  ASSERT_EQ(true, c.is_learned());
+  ASSERT_LT(1, c.learned_segments());
+  for (long i = 0; i < 3000; ++i) {
+    ASSERT_EQ(true, c.find(i * i * i, v));
+    ASSERT_EQ(i, v);
+    ASSERT_EQ(false, c.find(i * i * i + 2, v));
+  }
+  ASSERT_EQ(false, c.find(-1, v));
+  ASSERT_EQ(true, c.find((1L << 62) + 1, v));
+  ASSERT_EQ(-2, v);
+  c.set_insert_buffer(true); // buffered adds leave the model alone
+  c.add(2, 7);
+  ASSERT_EQ(true, c.is_learned());
+  ASSERT_EQ(true, c.find(2, v));
+  ASSERT_EQ(7, v);
+  c.set_insert_buffer(false);
+  ASSERT_EQ(false, c.is_learned());
+  ASSERT_EQ(0, c.learned_segments());
+  BinSearchCollection<long,int> u; // uniform keys fit in one segment
+  for (long i = 0; i < 5000; ++i)
+    u.add(i * 10, (int)i);
+  u.learn();
+  ASSERT_EQ(1, u.learned_segments());
+  ASSERT_EQ(true, u.find(49990, v));
+  ASSERT_EQ(4999, v);
+  u.remove(49990);
+  ASSERT_EQ(false, u.is_learned());
+  BinSearchCollection<std::string,int> s; // keys that aren't numbers keep binary search
+  s.add("a", 1);
+  ASSERT_EQ(false, s.learn());
+  ASSERT_EQ(false, s.is_learned());
+  ASSERT_EQ(true, s.find("a", v));
+}
+
+TEST(PMACollectionTest, AddFindRemoveRange) {
+  PMACollection<int,int> c;
+  int v;
+  ASSERT_EQ(false, c.find(1, v));
+  for (int i = 0; i < 2000; ++i) {
+    c.add((i * 1237) % 2000, i); // every key 0..1999 in scattered order
+    ASSERT_EQ(true, c.valid_pma());
+  }
+  ASSERT_EQ(2000, c.size());
+  ASSERT_LE(2000 * 4 / 3, c.capacity()); // the root stays under 0.75 full
+  for (int i = 0; i < 2000; ++i) {
+    ASSERT_EQ(true, c.find((i * 1237) % 2000, v));
+    ASSERT_EQ(i, v);
+  }
+  ASSERT_EQ(false, c.find(-1, v));
+  ASSERT_EQ(false, c.find(2000, v));
+  ArrayList<int> keys;
+  c.find(500, 599, keys);
+  ASSERT_EQ(100, keys.size());
+  for (int i = 0; i < 100; ++i)
+    ASSERT_EQ(500 + i, keys.data()[i]);
+  c.sort(keys);
+  ASSERT_EQ(2000, keys.size());
+  for (int i = 0; i < 2000; ++i)
+    ASSERT_EQ(i, keys.data()[i]);
+  size_t full = c.capacity();
+  for (int i = 0; i < 2000; ++i) { // keep every fourth key, the array shrinks
+    if (i % 4 != 3) {
+      c.remove(i);
+      c.remove(i); // a second time is a no-op
+      ASSERT_EQ(true, c.valid_pma());
+    }
+  }
+  ASSERT_EQ(500, c.size());
+  ASSERT_GT(full, c.capacity());
+  for (int i = 0; i < 2000; ++i)
+    ASSERT_EQ(i % 4 == 3, c.find(i, v));
+  PMACollection<int,int> copy = c;
+  for (int i = 3; i < 2000; i += 4)
+    c.remove(i);
+  ASSERT_EQ(0, c.size());
+  ASSERT_EQ(true, c.valid_pma());
+  ASSERT_EQ(500, copy.size());
+  ASSERT_EQ(true, copy.find(1999, v));
+  c.add(5, 50);
+  ASSERT_EQ(true, c.find(5, v));
+  ASSERT_EQ(50, v);
+}
+
+TEST(PMACollectionTest, StringKeys) {
+  PMACollection<string,int> c;
+  c.add("m", 1);
+  c.add("a", 2);
+  c.add("z", 3);
+  ArrayList<string> keys;
+  c.find("b", "z", keys);
+  ASSERT_EQ(2, keys.size());
+  ASSERT_EQ("m", keys.data()[0]);
+  ASSERT_EQ("z", keys.data()[1]);
+  c.keys(keys);
+  ASSERT_EQ(3, keys.size());
+}
+
+TEST(AdaptiveCollectionTest, PromoteAndDemote) {
+  AdaptiveCollection<int,int> c;
+  int v;
+  for (int i = 0; i < 32; ++i)
+    c.add(i, i * 10);
+  ASSERT_EQ(false, c.is_promoted()); // 32 pairs still fit inline
+  c.add(32, 320);
+  ASSERT_EQ(true, c.is_promoted());
+  for (int i = 33; i < 100; ++i)
+    c.add(i, i * 10);
+  ASSERT_EQ(100, c.size());
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(true, c.find(i, v));
+    ASSERT_EQ(i * 10, v);
+  }
+  ArrayList<int> keys;
+  c.find(10, 19, keys);
+  ASSERT_EQ(10, keys.size());
+  for (int i = 0; i < 92; ++i)
+    c.remove(i);
+  ASSERT_EQ(true, c.is_promoted()); // 8 left, not below the demote size
+  c.remove(92);
+  ASSERT_EQ(false, c.is_promoted());
+  ASSERT_EQ(7, c.size());
+  for (int i = 0; i < 100; ++i)
+    ASSERT_EQ(i > 92, c.find(i, v));
+  ASSERT_EQ(true, c.find(99, v));
+  ASSERT_EQ(990, v);
+  c.remove(95); // inline remove fills the hole with the last pair
+  c.remove(1000);
+  c.sort(keys);
+  ASSERT_EQ(6, keys.size());
+  ASSERT_EQ(93, keys.data()[0]);
+  ASSERT_EQ(96, keys.data()[2]);
+  ASSERT_EQ(99, keys.data()[5]);
+  c.find(94, 97, keys);
+  ASSERT_EQ(3, keys.size());
+  AdaptiveCollection<int,int> copy = c;
+  for (int i = 0; i < 40; ++i)
+    copy.add(200 + i, i);
+  ASSERT_EQ(true, copy.is_promoted());
+  ASSERT_EQ(false, c.is_promoted());
+  ASSERT_EQ(6, c.size());
+  ASSERT_EQ(46, copy.size());
+}
+
+TEST(FrozenHashCollectionTest, BuildAndFind) {
+  HashTableCollection<int,int> source;
+  for (int i = 0; i < 5000; ++i)
+    source.add(i * 7, i);
+  FrozenHashCollection<int,int> c(source);
+  ASSERT_EQ(5000, c.size());
+  int v;
+  for (int i = 0; i < 5000; ++i) {
+    ASSERT_EQ(true, c.find(i * 7, v));
+    ASSERT_EQ(i, v);
+  }
+  for (int i = 0; i < 5000; ++i)
+    ASSERT_EQ(false, c.find(i * 7 + 3, v));
+  c.add(1, 1); // read only
+  c.remove(7);
+  ASSERT_EQ(5000, c.size());
+  ASSERT_EQ(false, c.find(1, v));
+  ASSERT_EQ(true, c.find(7, v));
+  ArrayList<int> keys;
+  c.find(0, 69, keys);
+  ASSERT_EQ(10, keys.size());
+  c.sort(keys);
+  ASSERT_EQ(5000, keys.size());
+  for (int i = 0; i < 5000; ++i)
+    ASSERT_EQ(i * 7, keys.data()[i]);
+  FrozenHashCollection<int,int> copy = c;
+  ASSERT_EQ(true, copy.find(7 * 4999, v));
+  ASSERT_EQ(4999, v);
+  HashTableCollection<int,int> empty;
+  ASSERT_EQ(true, c.build(empty)); // rebuilding replaces everything
+  ASSERT_EQ(0, c.size());
+  ASSERT_EQ(false, c.find(7, v));
+}
+
+TEST(FrozenHashCollectionTest, AnySource) {
+  for (int n = 0; n <= 20; ++n) { // every size, including one key buckets only
+    RBTCollection<string,int> source;
+    for (int i = 0; i < n; ++i)
+      source.add("key" + to_string(i), i);
+    FrozenHashCollection<string,int> c(source);
+    ASSERT_EQ(n, c.size());
+    int v;
+    for (int i = 0; i < n; ++i) {
+      ASSERT_EQ(true, c.find("key" + to_string(i), v));
+      ASSERT_EQ(i, v);
+    }
+    ASSERT_EQ(false, c.find("key" + to_string(n), v));
+  }
+}
+
+// Removes rotate through a sentinel above the root, which has no key
+TEST(RBTCollectionTest, RemoveKeepsOtherKeys) {
+  RBTCollection<int,int> c;
+  int v;
+  for (int i = 0; i < 100; ++i)
+    c.add(i, i);
+  c.remove(1000); // missing keys are a no-op
+  c.remove(-1);
+  ASSERT_EQ(100, c.size());
+  ASSERT_EQ(true, c.valid_rbt());
+  for (int i = 0; i < 100; ++i) {
+    c.remove(i);
+    ASSERT_EQ(true, c.valid_rbt());
+    ASSERT_EQ(99 - i, c.size());
+    for (int j = i + 1; j < 100; ++j)
+      ASSERT_EQ(true, c.find(j, v));
+  }
+  c.remove(5);
+  ASSERT_EQ(0, c.size());
+}
+
+TEST(AVLCollectionTest, AddRemoveStayBalanced) {
+  AVLCollection<int,int> c;
+  int v;
+  for (int i = 0; i < 1000; ++i) {
+    c.add((i * 389) % 1000, i); // every key 0..999 in scattered order
+    ASSERT_EQ(true, c.valid_avl());
+  }
+  ASSERT_EQ(1000, c.size());
+  ASSERT_GE(15, c.height()); // 1.44 log2(1000) is about 14.4
+  for (int i = 0; i < 100; ++i)
+    c.add(2000 + i, i); // ascending runs rotate at every level
+  ASSERT_EQ(true, c.valid_avl());
+  c.remove(5000); // missing keys are a no-op
+  ASSERT_EQ(1100, c.size());
+  AVLCollection<int,int> copy(c); // copies keep their balance factors
+  ASSERT_EQ(true, copy.valid_avl());
+  ASSERT_EQ(c.height(), copy.height());
+  for (int i = 0; i < 1000; i += 2) {
+    c.remove(i);
+    ASSERT_EQ(true, c.valid_avl());
+  }
+  ASSERT_EQ(600, c.size());
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_EQ(i % 2 == 1, c.find(i, v));
+  ASSERT_EQ(1100, copy.size());
+  ASSERT_EQ(true, copy.find(0, v));
+  copy.add(-1, 0);
+  ASSERT_EQ(true, copy.valid_avl());
+  copy = AVLCollection<int,int>(); // assigning an empty tree empties it
+  ASSERT_EQ(0, copy.size());
+  ASSERT_EQ(true, copy.valid_avl());
+  ASSERT_EQ(false, copy.find(1, v));
+}
+
+// Collections empty a reused output list even when they have no keys
+TEST(RBTCollectionTest, ReusedOutputList) {
+  RBTCollection<int,int> c;
+  ArrayList<int> out;
+  for (int i = 0; i < 10; ++i)
+    out.add(i);
+  c.keys(out);
+  ASSERT_EQ(0, out.size());
+  c.add(1, 10);
+  c.add(2, 20);
+  c.find(0, 5, out);
+  c.find(0, 5, out);
+  ASSERT_EQ(2, out.size());
+}
+
+// Helper to check the incremental chain statistics of a hash table
+// against its chain length histogram
+template<typename K, typename V>
+void check_chain_stats(const HashTableCollection<K,V>& c)
+{
+  ArrayList<size_t> counts;
+  c.chain_histogram(counts);
+  size_t buckets = 0, pairs = 0, used = 0, min = 0, max = 0;
+  for (size_t len = 0; len < counts.size(); ++len) {
+    size_t count;
+    counts.get(len, count);
+    buckets += count;
+    pairs += len * count;
+    if (len > 0 && count > 0) {
+      used += count;
+      if (min == 0)
+        min = len;
+      max = len;
+    }
+  }
+  ASSERT_EQ(c.bucket_count(), buckets);
+  ASSERT_EQ(c.size(), pairs);
+  ASSERT_EQ(min, c.min_chain_length());
+  ASSERT_EQ(max, c.max_chain_length());
+  if (used > 0)
+    ASSERT_DOUBLE_EQ(pairs / (double)used, c.avg_chain_length());
+  else
+    ASSERT_DOUBLE_EQ(0, c.avg_chain_length());
+}
+
+// Hash table: chain statistics stay correct across adds, rehashes and
+// removes (including a chain of a single key)
+TEST(HashTableCollectionTest, ChainStatistics) {
+  HashTableCollection<int,int> c;
+  ASSERT_EQ(0, c.min_chain_length());
+  ASSERT_EQ(0, c.max_chain_length());
+  c.add(3, 30);
+  ASSERT_EQ(1, c.min_chain_length());
+  ASSERT_EQ(1, c.max_chain_length());
+  c.add(3 + 16, 40); // same bucket in a 16 bucket table
+  ASSERT_EQ(2, c.min_chain_length());
+  ASSERT_EQ(2, c.max_chain_length());
+  check_chain_stats(c);
+  for (int i = 100; i < 600; ++i) {
+    c.add(i * 7, i);
+    check_chain_stats(c);
+  }
+  for (int i = 100; i < 600; i += 3) {
+    c.remove(i * 7);
+    check_chain_stats(c);
+  }
+  c.remove(3);
+  c.remove(3 + 16);
+  check_chain_stats(c);
+}
+
+// Hash table: the ordered index answers range and sorted queries and
+// stays in sync through adds, removes, rehashes and copies
+TEST(HashTableCollectionTest, OrderedIndex) {
+  HashTableCollection<int,int> c;
+  for (int i = 0; i < 200; i += 2)
+    c.add(i, i*10);
+  c.set_ordered_index(true);
+  ASSERT_EQ(true, c.has_ordered_index());
+  for (int i = 1; i < 400; i += 2)
+    c.add(i, i*10);
+  for (int i = 0; i < 400; i += 3)
+    c.remove(i);
+  ArrayList<int> range;
+  c.find(10, 20, range);
+  int expected[] = {10, 11, 13, 14, 16, 17, 19, 20};
+  ASSERT_EQ(8, range.size());
+  for (size_t i = 0; i < range.size(); ++i) {
+    int k;
+    range.get(i, k);
+    ASSERT_EQ(expected[i], k);
+  }
+  ArrayList<int> sorted_keys;
+  c.sort(sorted_keys);
+  ASSERT_EQ(c.size(), sorted_keys.size());
+  for (size_t i = 1; i < sorted_keys.size(); ++i) {
+    int k1, k2;
+    sorted_keys.get(i-1, k1);
+    sorted_keys.get(i, k2);
+    ASSERT_LT(k1, k2);
+  }
+  HashTableCollection<int,int> copy(c);
+  ASSERT_EQ(true, copy.has_ordered_index());
+  ArrayList<int> copy_range;
+  copy.find(10, 20, copy_range);
+  ASSERT_EQ(8, copy_range.size());
+  c.set_ordered_index(false);
+  ArrayList<int> unindexed;
+  c.find(10, 20, unindexed);
+  ASSERT_EQ(8, unindexed.size());
+}
+
+// Hash table: removing one of several equal keys unlinks that exact
+// node from the ordered index, even after a rehash has reordered the
+// chains
+TEST(HashTableCollectionTest, OrderedIndexDuplicateKeys) {
+  HashTableCollection<int,int> c;
+  c.set_ordered_index(true);
+  for (int i = 0; i < 4; ++i)
+    c.add(5, i);
+  size_t start_buckets = c.bucket_count();
+  for (int i = 100; i < 2100; ++i)
+    c.add(i, i);
+  ASSERT_LT(start_buckets, c.bucket_count());
+  ArrayList<int> sorted_keys;
+  ArrayList<int> range;
+  for (int left = 3; left >= 0; --left) {
+    c.remove(5);
+    c.sort(sorted_keys);
+    ASSERT_EQ(c.size(), sorted_keys.size());
+    ASSERT_EQ(2000 + left, sorted_keys.size());
+    c.find(0, 10, range);
+    ASSERT_EQ(left, range.size());
+  }
+  int v;
+  ASSERT_EQ(false, c.find(5, v));
+}
+
+// Hash table: removing a pair from a copy (whose nodes share one slab)
+// releases its value right away, and adds reuse the removed nodes
+TEST(HashTableCollectionTest, CopyRemoveReleasesValues) {
+  std::shared_ptr<int> owned(new int(7));
+  HashTableCollection<int,std::shared_ptr<int>> c1;
+  for (int i = 0; i < 100; ++i)
+    c1.add(i, owned);
+  HashTableCollection<int,std::shared_ptr<int>> c2(c1);
+  ASSERT_EQ(201, owned.use_count());
+  for (int i = 0; i < 100; ++i)
+    c2.remove(i);
+  ASSERT_EQ(101, owned.use_count());
+  for (int i = 0; i < 50; ++i)
+    c2.add(i, owned);
+  ASSERT_EQ(151, owned.use_count());
+  std::shared_ptr<int> v;
+  ASSERT_EQ(true, c2.find(49, v));
+  ASSERT_EQ(7, *v);
+  v.reset();
+  c2 = HashTableCollection<int,std::shared_ptr<int>>();
+  ASSERT_EQ(101, owned.use_count());
+}
+
+// Hash table: copies keep every pair, chain statistics and the index,
+// and assignment replaces the old contents (large enough to copy in
+// parallel on multi-core machines)
+TEST(HashTableCollectionTest, CopyAndAssignment) {
+  HashTableCollection<int,int> c1;
+  for (int i = 0; i < 70000; ++i)
+    c1.add(i, i+1);
+  for (int i = 0; i < 70000; i += 5)
+    c1.remove(i);
+  HashTableCollection<int,int> c2(c1);
+  ASSERT_EQ(c1.size(), c2.size());
+  ASSERT_EQ(c1.bucket_count(), c2.bucket_count());
+  ASSERT_EQ(c1.max_chain_length(), c2.max_chain_length());
+  check_chain_stats(c2);
+  for (int i = 0; i < 70000; ++i) {
+    int v1 = 0, v2 = 0;
+    ASSERT_EQ(c1.find(i, v1), c2.find(i, v2));
+    ASSERT_EQ(v1, v2);
+  }
+  // removing and adding in the copy leaves the original alone
+  c2.remove(1);
+  c2.add(70000, 1);
+  int v;
+  ASSERT_EQ(true, c1.find(1, v));
+  check_chain_stats(c2);
+  HashTableCollection<int,int> c3;
+  c3.add(-1, 0);
+  c3.set_ordered_index(true);
+  c3 = c2;
+  c3 = c3;
+  ASSERT_EQ(false, c3.has_ordered_index());
+  ASSERT_EQ(c2.size(), c3.size());
+  ASSERT_EQ(false, c3.find(-1, v));
+  c2.set_ordered_index(true);
+  HashTableCollection<int,int> c4;
+  c4 = c2;
+  ASSERT_EQ(true, c4.has_ordered_index());
+  ArrayList<int> range;
+  c4.find(0, 20, range);
+  ASSERT_EQ(15, range.size());
+  for (int i = 0; i < 100; ++i)
+    c4.remove(i);
+  c4.find(0, 120, range);
+  ASSERT_EQ(16, range.size());
+}
+
+// Concurrent hash table: basic operations and growing past many resizes
+TEST(ConcurrentHashTableCollectionTest, AddFindRemove) {
+  ConcurrentHashTableCollection<int,int> c;
+  size_t start_buckets = c.bucket_count();
+  for (int i = 0; i < 1000; ++i)
+    c.add(i, i*10);
+  ASSERT_EQ(1000, c.size());
+  ASSERT_LT(start_buckets, c.bucket_count());
+  int v;
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_EQ(true, c.find(i, v));
+    ASSERT_EQ(i*10, v);
+  }
+  for (int i = 0; i < 1000; i += 2)
+    c.remove(i);
+  ASSERT_EQ(500, c.size());
+  ASSERT_EQ(false, c.find(10, v));
+  ASSERT_EQ(true, c.find(11, v));
+  ArrayList<int> sorted_keys;
+  c.sort(sorted_keys);
+  ASSERT_EQ(500, sorted_keys.size());
+  ArrayList<int> range;
+  c.find(100, 110, range);
+  ASSERT_EQ(5, range.size());
+}
+
+// Concurrent hash table: threads adding disjoint keys across resizes
+TEST(ConcurrentHashTableCollectionTest, ParallelAdds) {
+  ConcurrentHashTableCollection<int,int> c;
+  const int THREADS = 4;
+  const int PER_THREAD = 5000;
+  thread workers[THREADS];
+  for (int t = 0; t < THREADS; ++t)
+    workers[t] = thread([&c, t]() {
+      for (int i = 0; i < PER_THREAD; ++i) {
+        int v;
+        c.add(t*PER_THREAD + i, i);
+        c.find(t*PER_THREAD + i/2, v);
+      }
+    });
+  for (int t = 0; t < THREADS; ++t)
+    workers[t].join();
+  ASSERT_EQ(THREADS*PER_THREAD, c.size());
+  for (int i = 0; i < THREADS*PER_THREAD; ++i) {
+    int v;
+    ASSERT_EQ(true, c.find(i, v));
+    ASSERT_EQ(i % PER_THREAD, v);
+  }
+}
+
+// Split-ordered hash: buckets split as it grows and keys stay findable
+TEST(SplitOrderedHashCollectionTest, AddFindRemove) {
+  SplitOrderedHashCollection<int,int> c;
+  size_t start_buckets = c.bucket_count();
+  for (int i = 0; i < 2000; ++i)
+    c.add(i, i*10);
+  ASSERT_EQ(2000, c.size());
+  ASSERT_LT(start_buckets, c.bucket_count());
+  int v;
+  for (int i = 0; i < 2000; ++i) {
+    ASSERT_EQ(true, c.find(i, v));
+    ASSERT_EQ(i*10, v);
+  }
+  ASSERT_EQ(false, c.find(2000, v));
+  for (int i = 0; i < 2000; i += 2)
+    c.remove(i);
+  ASSERT_EQ(1000, c.size());
+  ASSERT_EQ(false, c.find(10, v));
+  ASSERT_EQ(true, c.find(11, v));
+  ArrayList<int> sorted_keys;
+  c.sort(sorted_keys);
+  ASSERT_EQ(1000, sorted_keys.size());
+  for (size_t i = 1; i < sorted_keys.size(); ++i) {
+    int k1, k2;
+    sorted_keys.get(i-1, k1);
+    sorted_keys.get(i, k2);
+    ASSERT_LT(k1, k2);
+  }
+  ArrayList<int> range;
+  c.find(100, 110, range);
+  ASSERT_EQ(5, range.size());
+}
+
+// Split-ordered hash: concurrent adds, removes and finds
+TEST(SplitOrderedHashCollectionTest, ParallelAddRemove) {
+  SplitOrderedHashCollection<int,int> c;
+  const int THREADS = 4;
+  const int PER_THREAD = 5000;
+  thread workers[THREADS];
+  for (int t = 0; t < THREADS; ++t)
+    workers[t] = thread([&c, t]() {
+      for (int i = 0; i < PER_THREAD; ++i)
+        c.add(t*PER_THREAD + i, i);
+      for (int i = 0; i < PER_THREAD; i += 2) {
+        int v;
+        c.remove(t*PER_THREAD + i);
+        c.find(t*PER_THREAD + i + 1, v);
+      }
+    });
+  for (int t = 0; t < THREADS; ++t)
+    workers[t].join();
+  ASSERT_EQ(THREADS*PER_THREAD/2, c.size());
+  for (int i = 0; i < THREADS*PER_THREAD; ++i) {
+    int v;
+    ASSERT_EQ(i % 2 == 1, c.find(i, v));
+  }
+}
+
+// More threads than epoch slots: the extra ones wait for a free slot
+TEST(SplitOrderedHashCollectionTest, MoreThreadsThanSlots) {
+  SplitOrderedHashCollection<int,int> c;
+  const int THREADS = 200;
+  const int PER_THREAD = 200;
+  thread workers[THREADS];
+  for (int t = 0; t < THREADS; ++t)
+    workers[t] = thread([&c, t]() {
+      for (int i = 0; i < PER_THREAD; ++i)
+        c.add(t*PER_THREAD + i, i);
+      for (int i = 0; i < PER_THREAD; i += 2)
+        c.remove(t*PER_THREAD + i);
+    });
+  for (int t = 0; t < THREADS; ++t)
+    workers[t].join();
+  ASSERT_EQ(THREADS*PER_THREAD/2, c.size());
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
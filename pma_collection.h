@@ -0,0 +1,429 @@
+//----------------------------------------------------------------------
+// FILE: pma_collection
+// NAME: Scott Tornquist
+// DATE: 10/19/2026
+// DESC: Implements a packed memory array version of the collection
+//       class. Keys are kept in sorted order in one array that is cut
+//       into segments of about log2(capacity) slots, each packed from
+//       the left and ending in a gap. An add only shifts its own
+//       segment; when that segment is full the smallest enclosing
+//       window (1, 2, 4, ... segments) that is still below its density
+//       threshold is spread out evenly again. Thresholds tighten from
+//       the leaves (1.0 full, 0.125 empty) to the root (0.75, 0.25),
+//       and the array doubles or halves when the root is out of
+//       bounds, so adds cost O(log^2 n) amortized while ordered scans
+//       still read one dense array.
+//----------------------------------------------------------------------
+
+
+#ifndef PMA_COLLECTION_H
+#define PMA_COLLECTION_H
+
+#include "array_list.h"
+#include "collection.h"
+
+template<typename K, typename V>
+class PMACollection : public Collection<K,V>
+{
+public:
+  // add a new key-value pair into the collection
+    void add(const K& a_key, const V& a_val);
+
+  // remove a key-value pair from the collection
+    void remove(const K& a_key);
+
+  // find and return the value associated with the key
+  // if key isn't found, returns false, otherwise true
+    bool find(const K& search_key, V& the_val) const;
+
+  // find and return each key >= k1 and <= k2
+    void find(const K& k1, const K& k2, ArrayList<K>& keys) const;
+
+  // return all of the keys in the collection
+    void keys(ArrayList<K>& all_keys) const;
+
+  // return all of the keys in ascending (sorted) order
+    void sort(ArrayList<K>& all_keys_sorted) const;
+
+  // return the number of key-value pairs in the collection
+    size_t size() const;
+
+    // constructor
+    PMACollection();
+
+    // number of slots (used or not) in the array
+    size_t capacity() const;
+
+    // for testing: keys are in order, every segment is packed, holds
+    // at least one pair (when the collection isn't empty) and the
+    // counts add up
+    bool valid_pma() const;
+
+private:
+
+    // slot i of segment s is at s*segment_size + i; only the first
+    // counts[s] slots of a segment are in use
+    ArrayList<K> key_slots;
+    ArrayList<V> val_slots;
+    ArrayList<size_t> counts;
+
+    // slots per segment (a power of two, at least MIN_SEGMENT)
+    size_t segment_size;
+
+    // number of segments (a power of two)
+    size_t segments;
+
+    // levels above the leaves (log2 of segments)
+    size_t height;
+
+    // number of k-v pairs stored in the collection
+    size_t length;
+
+    // smallest segment; keeps 0.125 of a leaf at one or more pairs
+    static const size_t MIN_SEGMENT = 8;
+
+    // density thresholds at the leaves and at the root
+    static constexpr double LEAF_UPPER = 1.0;
+    static constexpr double ROOT_UPPER = 0.75;
+    static constexpr double LEAF_LOWER = 0.125;
+    static constexpr double ROOT_LOWER = 0.25;
+
+    // thresholds for a window of 2^level segments
+    double upper_density(size_t level) const;
+    double lower_density(size_t level) const;
+
+    // empty array of the given number of slots (a power of two)
+    void layout(size_t slots);
+
+    // smallest array that holds n pairs at most half full
+    static size_t capacity_for(size_t n);
+
+    // last segment whose first key is <= key (0 if there is none)
+    size_t find_segment(const K& key) const;
+
+    // number of pairs in segment s with a key less than key
+    size_t slot_in(size_t s, const K& key) const;
+
+    // copy the pairs of n segments starting at first, in order, onto
+    // the end of ks and vs
+    void gather(size_t first, size_t n, ArrayList<K>& ks, ArrayList<V>& vs) const;
+
+    // lay ks and vs out evenly over n segments starting at first
+    void spread(size_t first, size_t n, const ArrayList<K>& ks, const ArrayList<V>& vs);
+
+    // smallest window around segment s (as its level) whose count,
+    // plus delta, is within that level's thresholds; height+1 if even
+    // the whole array is out of bounds
+    size_t find_window(size_t s, long delta, bool growing) const;
+};
+
+template<typename K, typename V>
+PMACollection<K,V>::PMACollection(){ //constructor
+    length = 0;
+    layout(MIN_SEGMENT);
+};
+
+template<typename K, typename V>
+double PMACollection<K,V>::upper_density(size_t level) const{
+    if(height == 0){ // a lone segment is the root
+        return ROOT_UPPER;
+    }
+    return LEAF_UPPER - (LEAF_UPPER - ROOT_UPPER)*level/height;
+};
+
+template<typename K, typename V>
+double PMACollection<K,V>::lower_density(size_t level) const{
+    if(height == 0){
+        return ROOT_LOWER;
+    }
+    return LEAF_LOWER + (ROOT_LOWER - LEAF_LOWER)*level/height;
+};
+
+template<typename K, typename V>
+size_t PMACollection<K,V>::capacity_for(size_t n){
+    size_t slots = MIN_SEGMENT;
+    while(slots < 2*n){
+        slots *= 2;
+    }
+    return slots;
+};
+
+template<typename K, typename V>
+void PMACollection<K,V>::layout(size_t slots){
+    size_t log_slots = 0;
+    while((size_t(1) << log_slots) < slots){
+        log_slots++;
+    }
+    segment_size = MIN_SEGMENT;
+    while(segment_size < log_slots){ // about log2(capacity) slots each
+        segment_size *= 2;
+    }
+    if(segment_size > slots){
+        segment_size = slots;
+    }
+    segments = slots/segment_size;
+    height = 0;
+    while((size_t(1) << height) < segments){
+        height++;
+    }
+    key_slots.clear();
+    val_slots.clear();
+    counts.clear();
+    key_slots.reserve(slots);
+    val_slots.reserve(slots);
+    counts.reserve(segments);
+    for(size_t i=0; i<slots; i++){
+        key_slots.add(K());
+        val_slots.add(V());
+    }
+    for(size_t s=0; s<segments; s++){
+        counts.add(0);
+    }
+};
+
+template<typename K, typename V>
+size_t PMACollection<K,V>::find_segment(const K& key) const{
+    // every segment holds at least one pair, so the first keys of the
+    // segments are sorted and can be binary searched
+    const K* slots = key_slots.data();
+    size_t lo = 0;
+    size_t n = segments;
+    while(n > 1){
+        size_t half = n/2;
+        if(!(key < slots[(lo + half)*segment_size])){
+            lo += half;
+        }
+        n -= half;
+    }
+    return lo;
+};
+
+template<typename K, typename V>
+size_t PMACollection<K,V>::slot_in(size_t s, const K& key) const{
+    const K* first = key_slots.data() + s*segment_size;
+    size_t lo = 0;
+    size_t hi = counts.data()[s];
+    while(lo < hi){
+        size_t mid = (lo + hi)/2;
+        if(first[mid] < key){
+            lo = mid + 1;
+        }
+        else{
+            hi = mid;
+        }
+    }
+    return lo;
+};
+
+template<typename K, typename V>
+void PMACollection<K,V>::gather(size_t first, size_t n, ArrayList<K>& ks, ArrayList<V>& vs) const{
+    for(size_t s=first; s<first + n; s++){
+        const K* seg_keys = key_slots.data() + s*segment_size;
+        const V* seg_vals = val_slots.data() + s*segment_size;
+        ks.append(seg_keys, counts.data()[s]);
+        vs.append(seg_vals, counts.data()[s]);
+    }
+};
+
+template<typename K, typename V>
+void PMACollection<K,V>::spread(size_t first, size_t n, const ArrayList<K>& ks, const ArrayList<V>& vs){
+    size_t m = ks.size();
+    size_t next = 0;
+    for(size_t s=first; s<first + n; s++){ // the first m%n segments take one extra
+        size_t take = m/n + (s - first < m%n ? 1 : 0);
+        K* seg_keys = key_slots.data() + s*segment_size;
+        V* seg_vals = val_slots.data() + s*segment_size;
+        for(size_t i=0; i<take; i++){
+            seg_keys[i] = ks.data()[next];
+            seg_vals[i] = vs.data()[next];
+            next++;
+        }
+        counts.data()[s] = take;
+    }
+};
+
+template<typename K, typename V>
+size_t PMACollection<K,V>::find_window(size_t s, long delta, bool growing) const{
+    for(size_t level=1; level<=height; level++){
+        size_t width = size_t(1) << level;
+        size_t first = s & ~(width - 1);
+        size_t count = 0;
+        for(size_t w=first; w<first + width; w++){
+            count += counts.data()[w];
+        }
+        double density = (double)(count + delta)/(width*segment_size);
+        if(growing ? density <= upper_density(level) : density >= lower_density(level)){
+            return level;
+        }
+    }
+    return height + 1;
+};
+
+template<typename K, typename V>
+void PMACollection<K,V>:: add(const K& a_key, const V& a_val){
+    size_t s = (length == 0) ? 0 : find_segment(a_key);
+    size_t pos = slot_in(s, a_key);
+    size_t count = counts.data()[s];
+    if(count + 1 <= upper_density(0)*segment_size){ // room in the segment, shift its tail only
+        K* seg_keys = key_slots.data() + s*segment_size;
+        V* seg_vals = val_slots.data() + s*segment_size;
+        for(size_t i=count; i>pos; i--){
+            seg_keys[i] = std::move(seg_keys[i-1]);
+            seg_vals[i] = std::move(seg_vals[i-1]);
+        }
+        seg_keys[pos] = a_key;
+        seg_vals[pos] = a_val;
+        counts.data()[s]++;
+        length++;
+        return;
+    }
+    size_t level = find_window(s, 1, true);
+    size_t width = (level <= height) ? (size_t(1) << level) : segments;
+    size_t first = (level <= height) ? (s & ~(width - 1)) : 0;
+    ArrayList<K> ks;
+    ArrayList<V> vs;
+    gather(first, s - first, ks, vs); // pairs before the new one
+    size_t offset = ks.size() + pos;
+    gather(s, first + width - s, ks, vs);
+    ks.insert(offset, &a_key, 1);
+    vs.insert(offset, &a_val, 1);
+    length++;
+    if(level > height){ // the whole array is too full, double it
+        layout(capacity_for(length));
+        spread(0, segments, ks, vs);
+    }
+    else{
+        spread(first, width, ks, vs);
+    }
+};
+
+template<typename K, typename V>
+void PMACollection<K,V>:: remove(const K& a_key){
+    if(length == 0){
+        return;
+    }
+    size_t s = find_segment(a_key);
+    size_t pos = slot_in(s, a_key);
+    size_t count = counts.data()[s];
+    K* seg_keys = key_slots.data() + s*segment_size;
+    V* seg_vals = val_slots.data() + s*segment_size;
+    if(pos == count || !(seg_keys[pos] == a_key)){ // not there
+        return;
+    }
+    for(size_t i=pos; i+1<count; i++){
+        seg_keys[i] = std::move(seg_keys[i+1]);
+        seg_vals[i] = std::move(seg_vals[i+1]);
+    }
+    counts.data()[s]--;
+    length--;
+    if(length == 0){
+        layout(MIN_SEGMENT);
+        return;
+    }
+    if(counts.data()[s] >= lower_density(0)*segment_size && counts.data()[s] > 0){
+        return;
+    }
+    size_t level = find_window(s, 0, false);
+    if(level <= height){ // even the window back out
+        size_t width = size_t(1) << level;
+        size_t first = s & ~(width - 1);
+        ArrayList<K> ks;
+        ArrayList<V> vs;
+        gather(first, width, ks, vs);
+        spread(first, width, ks, vs);
+    }
+    else if(capacity_for(length) < key_slots.size()){ // too sparse, halve it
+        ArrayList<K> ks;
+        ArrayList<V> vs;
+        gather(0, segments, ks, vs);
+        layout(capacity_for(length));
+        spread(0, segments, ks, vs);
+    }
+    else if(counts.data()[s] == 0){ // already as small as it gets
+        ArrayList<K> ks;
+        ArrayList<V> vs;
+        gather(0, segments, ks, vs);
+        spread(0, segments, ks, vs);
+    }
+};
+
+template<typename K, typename V>
+bool PMACollection<K,V>:: find(const K& search_key, V& the_val) const{
+    if(length == 0){
+        return false;
+    }
+    size_t s = find_segment(search_key);
+    size_t pos = slot_in(s, search_key);
+    size_t slot = s*segment_size + pos;
+    if(pos < counts.data()[s] && key_slots.data()[slot] == search_key){
+        the_val = val_slots.data()[slot];
+        return true;
+    }
+    return false; // if not found return false
+};
+
+template<typename K, typename V>
+void PMACollection<K,V>:: find(const K& k1, const K& k2, ArrayList<K>& keys) const{
+    keys.clear();
+    if(k2 >= k1 && length > 0){
+        size_t s = find_segment(k1);
+        size_t i = slot_in(s, k1);
+        for(; s<segments; s++, i=0){ // walk the segments in order until past k2
+            const K* seg_keys = key_slots.data() + s*segment_size;
+            for(; i<counts.data()[s]; i++){
+                if(k2 < seg_keys[i]){
+                    return;
+                }
+                keys.add(seg_keys[i]);
+            }
+        }
+    }
+};
+
+template<typename K, typename V>
+void PMACollection<K,V>:: keys(ArrayList<K>& all_keys) const{
+    all_keys.clear();
+    all_keys.reserve(length);
+    for(size_t s=0; s<segments; s++){ // the segments are already in order
+        all_keys.append(key_slots.data() + s*segment_size, counts.data()[s]);
+    }
+};
+
+template<typename K, typename V>
+void PMACollection<K,V>:: sort(ArrayList<K>& all_keys_sorted) const{
+    keys(all_keys_sorted); // all keys are already in sorted order
+};
+
+template<typename K, typename V>
+size_t PMACollection<K,V>:: size() const{
+    return length;
+};
+
+template<typename K, typename V>
+size_t PMACollection<K,V>:: capacity() const{
+    return key_slots.size();
+};
+
+template<typename K, typename V>
+bool PMACollection<K,V>:: valid_pma() const{
+    size_t total = 0;
+    const K* prev = nullptr;
+    for(size_t s=0; s<segments; s++){
+        size_t count = counts.data()[s];
+        if(count > segment_size || (count == 0 && length > 0)){
+            return false;
+        }
+        for(size_t i=0; i<count; i++){
+            const K* key = key_slots.data() + s*segment_size + i;
+            if(prev != nullptr && !(*prev < *key)){
+                return false;
+            }
+            prev = key;
+        }
+        total += count;
+    }
+    return total == length;
+};
+
+
+#endif
@@ -147,9 +147,10 @@ void RBTCollection<K,V>::rotate_right(Node* k2){ //simple right rotation
     // UPDATE K1's parent
     k1->parent = k2->parent;
 
-    // Set K1's new parent to K1 if it exits
+    // Set K1's new parent to K1 if it exits (by which side K2 was on, the
+    // remove sentinel has no key to compare against)
     if(k1->parent != nullptr){
-        if(k1->parent->key > k1->key){
+        if(k1->parent->left == k2){
             k1->parent->left = k1;
         }
         else{
@@ -181,9 +182,10 @@ void RBTCollection<K,V>::rotate_left(Node* k2){ //simple left rotation
     // UPDATE K1's parent
     k1->parent = k2->parent;
 
-    // Set K1's new paret to K1 if it exits
+    // Set K1's new paret to K1 if it exits (by which side K2 was on, the
+    // remove sentinel has no key to compare against)
     if(k1->parent != nullptr){
-        if(k1->parent->key > k1->key){
+        if(k1->parent->left == k2){
             k1->parent->left = k1;
         }
         else{
@@ -357,11 +359,17 @@ void RBTCollection<K,V>:: remove(const K& a_key){
                 remove_rebalance(x, x->left);
                 found = true;// makes sure this else executes befor exiting
             }
-            p = x->parent; //updating paretn
+            if(x != nullptr){
+                p = x->parent; //updating paretn
+            }
         } 
 
         //CHECK IF NODE WAS FOUND
-        if(found == false){
+        if(found == false){ // the rebalancing on the way down may still have moved the root
+            root = sentinel->right;
+            root->color = BLACK;
+            root->parent = nullptr;
+            delete sentinel;
             return;
         }
 
@@ -471,6 +479,10 @@ void RBTCollection<K,V>:: remove_rebalance(Node* x, bool going_right){
             x->color = RED;
             x->parent->color = BLACK;
         }
+    }// ROOT WITH TWO BLACK CHILDREN: only the root has no sibling, and
+    // making it red lets the flips below work under a red parent
+    else if(t == nullptr){
+        x->color = RED;
     }//CASE 2: COLOR FLIP // given X's children are both black// does t have 2 black or null children
     else if(t != nullptr && t->color == BLACK && (t->left == nullptr && (t->right == nullptr || t->right->color == BLACK) ||
      t->left != nullptr && (t->left->color == BLACK && (t->right == nullptr || t->right->color == BLACK))) ){
@@ -479,7 +491,8 @@ void RBTCollection<K,V>:: remove_rebalance(Node* x, bool going_right){
         p->color = BLACK;
 
     }//CASE 3 and 4: OUTSIDE AND INSIDE RED SIBLING CHILDREN //if R is right of T
-    else if(t!= nullptr && t->color == BLACK && t->right != nullptr && t->right->color == RED && (t->left == nullptr || t->left->color == BLACK)){
+    // (with two red children the outer one is used, as a single rotation)
+    else if(t!= nullptr && t->color == BLACK && t->right != nullptr && t->right->color == RED && (t->left == nullptr || t->left->color == BLACK || p->right == t)){
         //T is black, and has a Right RED NODE only to the right
         if(p->right == t){ //right-right case CASE 3
             rotate_left(p);
@@ -497,7 +510,7 @@ void RBTCollection<K,V>:: remove_rebalance(Node* x, bool going_right){
             //t->parent = BLACK;
         }
     }// if R is left of T
-    else if(t!= nullptr && t->color == BLACK && t->left != nullptr && t->left->color == RED && (t->right == nullptr || t->right->color == BLACK)){
+    else if(t!= nullptr && t->color == BLACK && t->left != nullptr && t->left->color == RED && (t->right == nullptr || t->right->color == BLACK || p->left == t)){
         //T is black, and has a Right RED NODE only to the left
         if(p->left == t){ //left-left case
             rotate_right(p);
@@ -584,20 +597,17 @@ bool RBTCollection<K,V>:: find(const K& search_key, V& the_val) const{
 
 template<typename K, typename V>
 void RBTCollection<K,V>:: find(const K& k1, const K& k2, ArrayList<K>& keys) const{ 
+    keys.clear(); // make return array empty
     if((k2 >= k1) && (size() > 0)){ // if we have a positive range and a postive size
-        while(keys.size()>0){// make return array empty
-            keys.remove(0);
-        }
           find(root, k1, k2, keys);
         }         
  };
 
 template<typename K, typename V>
 void RBTCollection<K,V>:: keys(ArrayList<K>& all_keys) const{
+all_keys.clear();
 if(size() > 0){
-    while(all_keys.size()>0){
-        all_keys.remove(0);
-    }
+    all_keys.reserve(size());
     keys(root, all_keys);
   }
  };
@@ -624,9 +634,9 @@ void RBTCollection<K,V>::find(const Node* subtree_root, const K& k1, const K& k2
   else if(subtree_root->key > k2){ // if current key is less than range go left
     find(subtree_root->left,k1,k2,keys);
   }
-  else { // if current key is in the range add to keys and go left and right
-    keys.add(subtree_root->key);
+  else { // if current key is in the range go left, add it and go right (keeps keys in order)
     find(subtree_root->left,k1,k2,keys);
+    keys.add(subtree_root->key);
     find(subtree_root->right,k1,k2,keys);
   }
   return;
@@ -667,6 +677,7 @@ RBTCollection<K,V>::~RBTCollection(){ //destructor
 template<typename K, typename V>
 RBTCollection<K,V>::RBTCollection(const RBTCollection <K,V>& rhs){
     root = nullptr;
+    node_count = 0;
     *this = rhs; // defers to assignment operator
 };
 
@@ -676,12 +687,15 @@ RBTCollection<K,V>& RBTCollection<K,V>::operator=(const RBTCollection<K,V>& rhs)
 if(this != &rhs){ // tree1 != tree1
   if(root != nullptr){
     make_empty(root);
+    root = nullptr;
   }
+  node_count = 0;
   if(rhs.size() >0){
   node_count = 1;
   root = new Node; //set root to something
   root->left = nullptr;
   root->right = nullptr;
+  root->parent = nullptr;
   copy(root, rhs.root);
   }
   }
@@ -721,10 +735,12 @@ void RBTCollection<K,V>::copy (Node* lhs_subtree_root, const Node* rhs_subtree_r
     lhs_subtree_root->left = nullptr;
     if(rhs_subtree_root->right != nullptr){
       lhs_subtree_root->right = new Node;
+      lhs_subtree_root->right->parent = lhs_subtree_root; // rebalancing walks up these
       node_count++;
     }
     if(rhs_subtree_root->left != nullptr){
       lhs_subtree_root->left = new Node;
+      lhs_subtree_root->left->parent = lhs_subtree_root;
       node_count++;
     }
     if(rhs_subtree_root->left != nullptr){
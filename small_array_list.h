@@ -0,0 +1,81 @@
+//----------------------------------------------------------------------
+// FILE: small_array_list
+// NAME: Scott Tornquist
+// DATE: 10/19/2026
+// DESC: Implements a resizable array list that keeps its first N
+//       items in a buffer inside the object and only moves them to
+//       the heap once there are more than N. It is an ArrayList, so
+//       it can be passed to any collection's keys, sort and range
+//       find functions; short results then allocate nothing.
+//----------------------------------------------------------------------
+
+#ifndef SMALL_ARRAY_LIST_H
+#define SMALL_ARRAY_LIST_H
+
+#include "array_list.h"
+#include <type_traits>
+
+template<typename T, size_t N = 16>
+class SmallArrayList : public ArrayList<T>
+{
+public:
+  SmallArrayList();
+  SmallArrayList(const ArrayList<T>& rhs);
+  SmallArrayList(const SmallArrayList<T,N>& rhs);
+  SmallArrayList(SmallArrayList<T,N>&& rhs);
+  SmallArrayList& operator=(const SmallArrayList<T,N>& rhs);
+  SmallArrayList& operator=(SmallArrayList<T,N>&& rhs);
+  // plain ArrayLists can be assigned in (and moved in) as well
+  using ArrayList<T>::operator=;
+
+  // true while the items still fit in the inline buffer
+  bool is_inline() const;
+
+private:
+  // raw inline slots, constructed and destroyed by ArrayList
+  typename std::aligned_storage<sizeof(T), alignof(T)>::type buffer[N];
+};
+
+
+template<typename T, size_t N>
+SmallArrayList<T,N>::SmallArrayList() : ArrayList<T>(reinterpret_cast<T*>(buffer), N)
+{
+}
+
+template<typename T, size_t N>
+SmallArrayList<T,N>::SmallArrayList(const ArrayList<T>& rhs) : ArrayList<T>(reinterpret_cast<T*>(buffer), N)
+{
+  ArrayList<T>::operator=(rhs);
+}
+
+template<typename T, size_t N>
+SmallArrayList<T,N>::SmallArrayList(const SmallArrayList<T,N>& rhs) : ArrayList<T>(reinterpret_cast<T*>(buffer), N)
+{
+  ArrayList<T>::operator=(rhs);
+}
+
+template<typename T, size_t N>
+SmallArrayList<T,N>::SmallArrayList(SmallArrayList<T,N>&& rhs) : ArrayList<T>(reinterpret_cast<T*>(buffer), N)
+{
+  this->take(rhs);
+}
+
+template<typename T, size_t N>
+SmallArrayList<T,N>& SmallArrayList<T,N>::operator=(const SmallArrayList<T,N>& rhs){
+  ArrayList<T>::operator=(rhs);
+  return *this;
+}
+
+template<typename T, size_t N>
+SmallArrayList<T,N>& SmallArrayList<T,N>::operator=(SmallArrayList<T,N>&& rhs){
+  ArrayList<T>::operator=(std::move(rhs));
+  return *this;
+}
+
+template<typename T, size_t N>
+bool SmallArrayList<T,N>::is_inline() const{
+  return this->using_inline();
+}
+
+
+#endif
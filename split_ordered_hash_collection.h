@@ -0,0 +1,563 @@
+//----------------------------------------------------------------------
+// FILE: split_ordered_hash_collection
+// NAME: Scott Tornquist
+// DATE: 10/19/2026
+// DESC: Implements a lock-free hash table version of the collection
+//       class using split-ordered lists (Shalev and Shavit). Every
+//       pair lives in one lock-free sorted linked list ordered by the
+//       bit-reversed hash of its key. Buckets are lazily initialized
+//       pointers to dummy nodes inside that list, so doubling the
+//       number of buckets never moves a node. Nodes unlinked by
+//       remove are reclaimed with epoch-based reclamation: a node is
+//       only freed once every thread that could still be looking at
+//       it has finished its operation. Each running operation holds
+//       one of MAX_SLOTS (128) epoch slots, so at most 128 threads
+//       work in the table at once; any more wait (yielding the CPU)
+//       until a slot frees up.
+//----------------------------------------------------------------------
+
+
+#ifndef SPLIT_ORDERED_HASH_COLLECTION_H
+#define SPLIT_ORDERED_HASH_COLLECTION_H
+
+#include "array_list.h"
+#include "collection.h"
+#include <functional>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+
+template<typename K, typename V>
+class SplitOrderedHashCollection : public Collection<K,V>
+{
+public:
+  // add a new key-value pair into the collection
+    void add(const K& a_key, const V& a_val);
+
+  // remove a key-value pair from the collection
+    void remove(const K& a_key);
+
+  // find and return the value associated with the key
+  // if key isn't found, returns false, otherwise true
+    bool find(const K& search_key, V& the_val) const;
+
+  // find and return each key >= k1 and <= k2
+    void find(const K& k1, const K& k2, ArrayList<K>& keys) const;
+
+  // return all of the keys in the collection
+    void keys(ArrayList<K>& all_keys) const;
+
+  // return all of the keys in ascending (sorted) order
+    void sort(ArrayList<K>& all_keys_sorted) const;
+
+  // return the number of key-value pairs in the collection
+    size_t size() const;
+
+    // constructor
+    SplitOrderedHashCollection();
+
+    //destructor (no other thread may be using the collection)
+    ~SplitOrderedHashCollection();
+
+    // shared lock-free state cannot be copied
+    SplitOrderedHashCollection(const SplitOrderedHashCollection<K,V>& rhs) = delete;
+    SplitOrderedHashCollection& operator=(const SplitOrderedHashCollection<K,V>& rhs) = delete;
+
+    // current number of (logical) buckets
+    size_t bucket_count() const;
+
+
+private:
+
+    // list node, dummy (bucket) nodes have an even split-order key and
+    // regular nodes an odd one; the low bit of next marks a node as
+    // logically deleted
+    struct Node{
+        uint64_t so_key;
+        K key;
+        V value;
+        std::atomic<uintptr_t> next;
+        Node* retired_next;
+        size_t retire_epoch;
+    };
+
+    // announced epoch of a thread inside an operation (0 = slot free)
+    struct Slot{
+        std::atomic<size_t> epoch;
+        char padding[56];
+    };
+
+    // claims an epoch slot for the length of one operation
+    class Guard{
+    public:
+        Guard(const SplitOrderedHashCollection<K,V>& c);
+        ~Guard();
+    private:
+        const SplitOrderedHashCollection<K,V>& coll;
+        size_t slot;
+    };
+
+    // segment 0 holds the first 2^MIN_SEGMENT_BITS buckets and segment
+    // i > 0 holds 2^(MIN_SEGMENT_BITS+i-1) more, so the directory
+    // never has to be reallocated
+    static const size_t MIN_SEGMENT_BITS = 6;
+    static const size_t SEGMENTS = 64 - MIN_SEGMENT_BITS + 1;
+    static const size_t MAX_BUCKETS = (size_t)1 << 40;
+
+    // average number of pairs per bucket before doubling the buckets
+    static const size_t LOAD_FACTOR = 2;
+
+    // maximum number of threads inside operations at the same time
+    static const size_t MAX_SLOTS = 128;
+
+    // try to reclaim retired nodes after this many removes
+    static const size_t RECLAIM_EVERY = 64;
+
+    // directory of lazily allocated bucket segments
+    mutable std::atomic<std::atomic<Node*>*> segments[SEGMENTS];
+
+    // current number of buckets (always a power of two)
+    std::atomic<size_t> bucket_size;
+
+    // number of k-v pairs stored in the collection
+    std::atomic<size_t> length;
+
+    // epoch based reclamation state
+    mutable Slot slots[MAX_SLOTS];
+    std::atomic<size_t> global_epoch;
+    std::atomic<Node*> retired_head;
+    std::atomic<size_t> retired_count;
+    std::atomic<bool> reclaiming;
+
+    // split-order keys
+    static uint64_t reverse_bits(uint64_t x);
+    static uint64_t so_regular(size_t code);
+    static uint64_t so_dummy(size_t bucket);
+
+    // pointer and mark helpers for the next fields
+    static Node* ptr(uintptr_t link);
+    static bool marked(uintptr_t link);
+
+    // bucket slot, allocating its segment when create is true
+    std::atomic<Node*>* bucket_slot(size_t bucket, bool create) const;
+
+    // returns the dummy node of a bucket, creating it if needed
+    Node* bucket_head(size_t bucket);
+
+    // dummy node of the bucket or its closest initialized parent
+    Node* read_head(size_t bucket) const;
+
+    // creates and links in the dummy node of a bucket
+    void initialize_bucket(size_t bucket);
+
+    // Michael's list search from head: on return cur is the first
+    // unmarked node that is not before (so_key, key) and prev is the
+    // link pointing at it; marked nodes on the way are unlinked.
+    // returns true if cur matches (a nullptr key matches any dummy)
+    bool list_find(Node* head, uint64_t so_key, const K* key,
+                   std::atomic<uintptr_t>*& prev, Node*& cur);
+
+    // links node in after head in order, sets existing and returns
+    // false if an equal node is already there
+    bool list_insert(Node* head, Node* node, Node*& existing);
+
+    // marks and unlinks the matching node, returns false if not found
+    bool list_delete(Node* head, uint64_t so_key, const K& key);
+
+    // epoch based reclamation helpers
+    void retire(Node* node);
+    void reclaim();
+};
+
+
+template<typename K, typename V>
+SplitOrderedHashCollection<K,V>::Guard::Guard(const SplitOrderedHashCollection<K,V>& c) : coll(c){
+    std::hash<std::thread::id> id_hash;
+    slot = id_hash(std::this_thread::get_id())%MAX_SLOTS;
+    for(size_t probes = 1; ; probes++){ // probe for a free slot and announce the current epoch in it
+        size_t expected = 0;
+        size_t e = coll.global_epoch.load();
+        if(coll.slots[slot].epoch.compare_exchange_strong(expected, e)){
+            return;
+        }
+        slot = (slot+1)%MAX_SLOTS;
+        if(probes % MAX_SLOTS == 0){ // every slot is busy, let their owners finish
+            std::this_thread::yield();
+        }
+    }
+};
+
+template<typename K, typename V>
+SplitOrderedHashCollection<K,V>::Guard::~Guard(){
+    coll.slots[slot].epoch.store(0);
+};
+
+template<typename K, typename V>
+uint64_t SplitOrderedHashCollection<K,V>::reverse_bits(uint64_t x){
+    x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+    x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+    x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    x = ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+    x = ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+    return (x >> 32) | (x << 32);
+};
+
+template<typename K, typename V>
+uint64_t SplitOrderedHashCollection<K,V>::so_regular(size_t code){
+    return reverse_bits((uint64_t)code | 0x8000000000000000ULL); // odd
+};
+
+template<typename K, typename V>
+uint64_t SplitOrderedHashCollection<K,V>::so_dummy(size_t bucket){
+    return reverse_bits((uint64_t)bucket); // even
+};
+
+template<typename K, typename V>
+typename SplitOrderedHashCollection<K,V>::Node*
+SplitOrderedHashCollection<K,V>::ptr(uintptr_t link){
+    return (Node*)(link & ~(uintptr_t)1);
+};
+
+template<typename K, typename V>
+bool SplitOrderedHashCollection<K,V>::marked(uintptr_t link){
+    return (link & 1) != 0;
+};
+
+template<typename K, typename V>
+SplitOrderedHashCollection<K,V>::SplitOrderedHashCollection(){ //constructor
+    for(size_t i=0; i<SEGMENTS; i++){
+        segments[i] = nullptr;
+    }
+    for(size_t i=0; i<MAX_SLOTS; i++){
+        slots[i].epoch = 0;
+    }
+    global_epoch = 1;
+    retired_head = nullptr;
+    retired_count = 0;
+    reclaiming = false;
+    length = 0;
+    bucket_size = (size_t)1 << MIN_SEGMENT_BITS;
+    Node* head = new Node; // bucket 0 is the head of the whole list
+    head->so_key = so_dummy(0);
+    head->next = 0;
+    bucket_slot(0, true)->store(head);
+};
+
+template<typename K, typename V>
+SplitOrderedHashCollection<K,V>::~SplitOrderedHashCollection(){ //destructor
+    Node* itr = bucket_slot(0, false)->load();
+    while(itr != nullptr){ // every node still linked, dummies included
+        Node* next = ptr(itr->next.load());
+        delete itr;
+        itr = next;
+    }
+    itr = retired_head.load();
+    while(itr != nullptr){ // unlinked nodes waiting to be reclaimed
+        Node* next = itr->retired_next;
+        delete itr;
+        itr = next;
+    }
+    for(size_t i=0; i<SEGMENTS; i++){
+        delete [] segments[i].load();
+    }
+};
+
+template<typename K, typename V>
+std::atomic<typename SplitOrderedHashCollection<K,V>::Node*>*
+SplitOrderedHashCollection<K,V>::bucket_slot(size_t bucket, bool create) const{
+    size_t seg = 0;
+    size_t offset = bucket;
+    size_t seg_size = (size_t)1 << MIN_SEGMENT_BITS;
+    if(bucket >= seg_size){ // segment i > 0 starts at 2^(MIN_SEGMENT_BITS+i-1)
+        size_t high = 63 - __builtin_clzll((unsigned long long)bucket);
+        seg = high - MIN_SEGMENT_BITS + 1;
+        seg_size = (size_t)1 << high;
+        offset = bucket - seg_size;
+    }
+    std::atomic<Node*>* segment = segments[seg].load();
+    if(segment == nullptr){
+        if(!create){
+            return nullptr;
+        }
+        std::atomic<Node*>* fresh = new std::atomic<Node*>[seg_size];
+        for(size_t i=0; i<seg_size; i++){
+            fresh[i] = nullptr;
+        }
+        if(segments[seg].compare_exchange_strong(segment, fresh)){
+            segment = fresh;
+        }
+        else{ // another thread allocated it first
+            delete [] fresh;
+        }
+    }
+    return &segment[offset];
+};
+
+template<typename K, typename V>
+void SplitOrderedHashCollection<K,V>::initialize_bucket(size_t bucket){
+    size_t parent = bucket & ~((size_t)1 << (63 - __builtin_clzll((unsigned long long)bucket)));
+    Node* parent_head = bucket_head(parent); // initializes the parent first if needed
+    Node* dummy = new Node;
+    dummy->so_key = so_dummy(bucket);
+    dummy->next = 0;
+    Node* existing = nullptr;
+    if(!list_insert(parent_head, dummy, existing)){ // someone else linked it in
+        delete dummy;
+        dummy = existing;
+    }
+    Node* expected = nullptr;
+    bucket_slot(bucket, true)->compare_exchange_strong(expected, dummy);
+};
+
+template<typename K, typename V>
+typename SplitOrderedHashCollection<K,V>::Node*
+SplitOrderedHashCollection<K,V>::bucket_head(size_t bucket){
+    Node* head = bucket_slot(bucket, true)->load();
+    if(head == nullptr){
+        initialize_bucket(bucket);
+        head = bucket_slot(bucket, true)->load();
+    }
+    return head;
+};
+
+template<typename K, typename V>
+typename SplitOrderedHashCollection<K,V>::Node*
+SplitOrderedHashCollection<K,V>::read_head(size_t bucket) const{
+    for(;;){ // a parent's dummy always comes before the bucket's keys
+        std::atomic<Node*>* slot = bucket_slot(bucket, false);
+        Node* head = (slot == nullptr) ? nullptr : slot->load();
+        if(head != nullptr){
+            return head;
+        }
+        bucket &= ~((size_t)1 << (63 - __builtin_clzll((unsigned long long)bucket)));
+    }
+};
+
+template<typename K, typename V>
+bool SplitOrderedHashCollection<K,V>::list_find(Node* head, uint64_t so_key, const K* key,
+                                                std::atomic<uintptr_t>*& prev, Node*& cur){
+try_again:
+    prev = &head->next;
+    cur = ptr(prev->load());
+    for(;;){
+        if(cur == nullptr){
+            return false;
+        }
+        uintptr_t cur_next = cur->next.load();
+        if(prev->load() != (uintptr_t)cur){ // prev was changed or marked under us
+            goto try_again;
+        }
+        if(!marked(cur_next)){
+            if(cur->so_key > so_key){
+                return false;
+            }
+            if(cur->so_key == so_key && (key == nullptr || cur->key == *key)){
+                return true;
+            }
+            prev = &cur->next;
+        }
+        else{ // help unlink a logically deleted node
+            uintptr_t expected = (uintptr_t)cur;
+            if(!prev->compare_exchange_strong(expected, (uintptr_t)ptr(cur_next))){
+                goto try_again;
+            }
+            retire(cur);
+        }
+        cur = ptr(cur_next);
+    }
+};
+
+template<typename K, typename V>
+bool SplitOrderedHashCollection<K,V>::list_insert(Node* head, Node* node, Node*& existing){
+    const K* key = (node->so_key & 1) ? &node->key : nullptr;
+    for(;;){
+        std::atomic<uintptr_t>* prev;
+        Node* cur;
+        if(list_find(head, node->so_key, key, prev, cur)){
+            existing = cur;
+            return false;
+        }
+        node->next.store((uintptr_t)cur);
+        uintptr_t expected = (uintptr_t)cur;
+        if(prev->compare_exchange_strong(expected, (uintptr_t)node)){
+            return true;
+        }
+    }
+};
+
+template<typename K, typename V>
+bool SplitOrderedHashCollection<K,V>::list_delete(Node* head, uint64_t so_key, const K& key){
+    for(;;){
+        std::atomic<uintptr_t>* prev;
+        Node* cur;
+        if(!list_find(head, so_key, &key, prev, cur)){
+            return false;
+        }
+        uintptr_t next = cur->next.load();
+        if(marked(next)){ // another remove got there first
+            continue;
+        }
+        if(!cur->next.compare_exchange_strong(next, next | 1)){ // logical delete
+            continue;
+        }
+        uintptr_t expected = (uintptr_t)cur;
+        if(prev->compare_exchange_strong(expected, next)){ // physical delete
+            retire(cur);
+        }
+        else{ // let a search unlink it
+            list_find(head, so_key, &key, prev, cur);
+        }
+        return true;
+    }
+};
+
+template<typename K, typename V>
+void SplitOrderedHashCollection<K,V>::retire(Node* node){
+    node->retire_epoch = global_epoch.load();
+    Node* head = retired_head.load();
+    do{ // push onto the retired stack
+        node->retired_next = head;
+    } while(!retired_head.compare_exchange_weak(head, node));
+    if(++retired_count % RECLAIM_EVERY == 0){
+        reclaim();
+    }
+};
+
+template<typename K, typename V>
+void SplitOrderedHashCollection<K,V>::reclaim(){
+    if(reclaiming.exchange(true)){ // someone else is already reclaiming
+        return;
+    }
+    // a thread that announced epoch e can only still see nodes retired
+    // at epoch >= e, so anything older than every announcement is free
+    size_t min_epoch = global_epoch.fetch_add(1) + 1;
+    for(size_t i=0; i<MAX_SLOTS; i++){
+        size_t e = slots[i].epoch.load();
+        if(e != 0 && e < min_epoch){
+            min_epoch = e;
+        }
+    }
+    Node* itr = retired_head.exchange(nullptr);
+    Node* keep = nullptr;
+    Node* keep_tail = nullptr;
+    while(itr != nullptr){
+        Node* next = itr->retired_next;
+        if(itr->retire_epoch < min_epoch){
+            delete itr;
+        }
+        else{
+            itr->retired_next = keep;
+            keep = itr;
+            if(keep_tail == nullptr){
+                keep_tail = itr;
+            }
+        }
+        itr = next;
+    }
+    if(keep != nullptr){ // put back what is still in use
+        Node* head = retired_head.load();
+        do{
+            keep_tail->retired_next = head;
+        } while(!retired_head.compare_exchange_weak(head, keep));
+    }
+    reclaiming.store(false);
+};
+
+template<typename K, typename V>
+void SplitOrderedHashCollection<K,V>:: add(const K& a_key, const V& a_val){
+    Guard guard(*this);
+    std::hash<K> hash_fun;
+    size_t code = hash_fun(a_key);
+    size_t buckets = bucket_size.load();
+    Node* head = bucket_head(code & (buckets-1));
+    Node* node = new Node;
+    node->so_key = so_regular(code);
+    node->key = a_key;
+    node->value = a_val;
+    Node* existing = nullptr;
+    if(!list_insert(head, node, existing)){ // never published, so safe to delete
+        delete node;
+        return;
+    }
+    if(++length > LOAD_FACTOR*buckets && buckets < MAX_BUCKETS){
+        bucket_size.compare_exchange_strong(buckets, 2*buckets); // buckets split lazily
+    }
+};
+
+template<typename K, typename V>
+void SplitOrderedHashCollection<K,V>:: remove(const K& a_key){
+    Guard guard(*this);
+    std::hash<K> hash_fun;
+    size_t code = hash_fun(a_key);
+    Node* head = bucket_head(code & (bucket_size.load()-1));
+    if(list_delete(head, so_regular(code), a_key)){
+        length--;
+    }
+};
+
+template<typename K, typename V>
+bool SplitOrderedHashCollection<K,V>:: find(const K& search_key, V& the_val) const{
+    Guard guard(*this);
+    std::hash<K> hash_fun;
+    size_t code = hash_fun(search_key);
+    uint64_t so_key = so_regular(code);
+    Node* itr = ptr(read_head(code & (bucket_size.load()-1))->next.load());
+    while(itr != nullptr && itr->so_key <= so_key){ // read only walk, skipping deleted nodes
+        uintptr_t next = itr->next.load();
+        if(itr->so_key == so_key && !marked(next) && itr->key == search_key){
+            the_val = itr->value;
+            return true;
+        }
+        itr = ptr(next);
+    }
+    return false;
+};
+
+template<typename K, typename V>
+void SplitOrderedHashCollection<K,V>:: find(const K& k1, const K& k2, ArrayList<K>& keys) const{
+    keys.clear();
+    if(k2 >= k1){
+        Guard guard(*this);
+        Node* itr = ptr(read_head(0)->next.load());
+        while(itr != nullptr){ // every regular node that is not deleted
+            uintptr_t next = itr->next.load();
+            if((itr->so_key & 1) && !marked(next) && itr->key >= k1 && itr->key <= k2){
+                keys.add(itr->key);
+            }
+            itr = ptr(next);
+        }
+    }
+};
+
+template<typename K, typename V>
+void SplitOrderedHashCollection<K,V>:: keys(ArrayList<K>& all_keys) const{
+    all_keys.clear();
+    Guard guard(*this);
+    Node* itr = ptr(read_head(0)->next.load());
+    while(itr != nullptr){
+        uintptr_t next = itr->next.load();
+        if((itr->so_key & 1) && !marked(next)){
+            all_keys.add(itr->key);
+        }
+        itr = ptr(next);
+    }
+};
+
+template<typename K, typename V>
+void SplitOrderedHashCollection<K,V>:: sort(ArrayList<K>& all_keys_sorted) const{
+    keys(all_keys_sorted); // get all keys frome the list
+    all_keys_sorted.sort(); // split order is not key order, so sort them
+};
+
+template<typename K, typename V>
+size_t SplitOrderedHashCollection<K,V>:: size() const{
+    return length;
+};
+
+template<typename K, typename V>
+size_t SplitOrderedHashCollection<K,V>:: bucket_count() const{
+    return bucket_size;
+};
+
+
+#endif